@@ -712,27 +712,8 @@ namespace ngbla
     integer lda = n;
     integer ldb = n;
 
-    cout << " zhegv " << endl; 
-
-    cout << " A s " << endl; 
-    for(int j=0;j<n;j++)
-      {
-	for(int k=0;k<n;k++)	
-	  cout <<  A[j*n+k] << " \t " ; 
-	cout << endl; 
-      }
-    cout << " M " << endl; 
-    for(int j=0;j<n;j++)
-      {
-	for(int k=0;k<n;k++)	
-	  cout <<  B[j*n+k] << " \t " ; 
-	cout << endl; 
-      }
-
-
     zhegv_(&itype,&jobzm,&uplo , &n , A , &lda, B, &ldb, lami, work, &lwork, rwork, &info); 
 
-    cout << " ... is back " << endl; 
     if(info != 0) 
       {
         cout << "LapackGHEPEPairs Info " << info << endl;  
@@ -23,9 +23,20 @@ namespace ngcomp
     bool block;
     bool hypre;
 
+    /// keep he, het and the inner inverse as dense element matrices
+    bool elementstorage;
+    /// wirebasket and interface dofs per element, volume elements first
+    Table<int> el_wbdofs, el_ifdofs;
+    /// per element: he, het (non-symmetric only), inner inverse
+    Array<size_t> eloffset;
+    Array<SCAL, size_t> elstorage;
+    enum { HARMONICEXT, HARMONICEXT_TRANS, INNERSOLVE };
+
     shared_ptr<BaseMatrix> inv;
     shared_ptr<BaseMatrix> inv_coarse;
     string inversetype;
+    /// "direct" or "amg" for the wirebasket problem
+    string coarsetype;
     BitArray * free_dofs;
 
     BaseVector * tmp;
@@ -36,8 +47,10 @@ namespace ngcomp
     void SetHypre (bool ah = true) { hypre = ah; }
     
     BDDCMatrix (const BilinearForm & abfa, 
-		const string & ainversetype, bool ablock, bool ahypre)
-      : bfa(abfa), block(ablock), inversetype(ainversetype)
+		const string & ainversetype, const string & acoarsetype,
+                bool ablock, bool ahypre, bool aelementstorage = false)
+      : bfa(abfa), block(ablock), elementstorage(aelementstorage),
+        inversetype(ainversetype), coarsetype(acoarsetype)
     {
       static Timer timer ("BDDC Constructor");
 
@@ -108,37 +121,121 @@ namespace ngcomp
       
       int ndof = fes->GetNDof();      
       
-      if (!bfa.IsSymmetric())
+      // with elementstorage, these are dense element matrices in elstorage
+      harmonicext = sparse_harmonicext = NULL;
+      harmonicexttrans = sparse_harmonicexttrans = NULL;
+      innersolve = sparse_innersolve = NULL;
+
+      if (!bfa.IsSymmetric() && !elementstorage)
 	{
 	  harmonicexttrans = sparse_harmonicexttrans =
 	    new SparseMatrix<SCAL,TV,TV>(ndof, el2wbdofs, el2ifdofs, false);
 	  harmonicexttrans -> AsVector() = 0.0;
 	}
-      else
-	harmonicexttrans = sparse_harmonicexttrans = NULL;
-
 
-      innersolve = sparse_innersolve = bfa.IsSymmetric() 
-	? new SparseMatrixSymmetric<SCAL,TV>(ndof, el2ifdofs)
-	: new SparseMatrix<SCAL,TV,TV>(ndof, el2ifdofs, el2ifdofs, bfa.IsSymmetric());
-      innersolve->AsVector() = 0.0;
-
-      harmonicext = sparse_harmonicext =
-	new SparseMatrix<SCAL,TV,TV>(ndof, el2ifdofs, el2wbdofs, false);
-      harmonicext->AsVector() = 0.0;
+      if (!elementstorage)
+        {
+          innersolve = sparse_innersolve = bfa.IsSymmetric() 
+            ? new SparseMatrixSymmetric<SCAL,TV>(ndof, el2ifdofs)
+            : new SparseMatrix<SCAL,TV,TV>(ndof, el2ifdofs, el2ifdofs, bfa.IsSymmetric());
+          innersolve->AsVector() = 0.0;
+
+          harmonicext = sparse_harmonicext =
+            new SparseMatrix<SCAL,TV,TV>(ndof, el2ifdofs, el2wbdofs, false);
+          harmonicext->AsVector() = 0.0;
+        }
 
       pwbmat = bfa.IsSymmetric() && !hypre
 	? new SparseMatrixSymmetric<SCAL,TV>(ndof, el2wbdofs)
 	: new SparseMatrix<SCAL,TV,TV>(ndof, el2wbdofs, el2wbdofs, bfa.IsSymmetric() && !hypre);
       pwbmat -> AsVector() = 0.0;
       pwbmat -> SetInverseType (inversetype);
+
+      if (elementstorage)
+        {
+          int nmats = bfa.IsSymmetric() ? 1 : 2;
+          eloffset.SetSize (el2wbdofs.Size()+1);
+          eloffset[0] = 0;
+          for (int i = 0; i < el2wbdofs.Size(); i++)
+            {
+              size_t sizew = el2wbdofs[i].Size(), sizei = el2ifdofs[i].Size();
+              eloffset[i+1] = eloffset[i] + nmats*sizei*sizew + sizei*sizei;
+            }
+          elstorage.SetSize (eloffset.Last());
+          elstorage = SCAL(0.0);
+          el_wbdofs = move(el2wbdofs);
+          el_ifdofs = move(el2ifdofs);
+        }
       
       weight.SetSize (fes->GetNDof());
       weight = 0;
     }
 
     
-    void AddMatrix (FlatMatrix<SCAL> elmat, FlatArray<int> dnums, LocalHeap & lh)
+    /// index into the element tables
+    int ElementIndex (ElementId id) const
+    {
+      return id.IsBoundary() ? bfa.GetFESpace()->GetMeshAccess()->GetNE() + id.Nr() : id.Nr();
+    }
+
+    /// dense element matrix of kind HARMONICEXT, HARMONICEXT_TRANS or INNERSOLVE
+    FlatMatrix<SCAL> ElementMatrix (int ii, int kind) const
+    {
+      size_t sizew = el_wbdofs[ii].Size(), sizei = el_ifdofs[ii].Size();
+      SCAL * first = &elstorage[eloffset[ii]];
+      switch (kind)
+        {
+        case HARMONICEXT:
+          return FlatMatrix<SCAL> (sizei, sizew, first);
+        case HARMONICEXT_TRANS:
+          return FlatMatrix<SCAL> (sizew, sizei, first+sizei*sizew);
+        default:
+          if (!bfa.IsSymmetric()) first += sizei*sizew;
+          return FlatMatrix<SCAL> (sizei, sizei, first+sizei*sizew);
+        }
+    }
+
+    /**
+       y += E x for the element matrices of one kind.
+       Elements of one color do not share dofs, they are applied in parallel.
+    */
+    void MultAddElements (int kind, FlatVector<TV> fx, FlatVector<TV> fy) const
+    {
+      static Timer timer ("BDDC - element matrices");
+      RegionTimer reg(timer);
+
+      auto fes = bfa.GetFESpace();
+      int nvol = fes->GetMeshAccess()->GetNE();
+      bool trans = (kind == HARMONICEXT_TRANS) && bfa.IsSymmetric();
+
+#pragma omp parallel
+      {
+        for (VorB vb : { VOL, BND })
+          for (FlatArray<int> els : fes->ElementColoring(vb))
+            {
+#pragma omp for schedule(dynamic,10)
+              for (int k = 0; k < els.Size(); k++)
+                {
+                  int ii = (vb == BND) ? nvol + els[k] : els[k];
+                  FlatArray<int> rows = (kind == HARMONICEXT_TRANS) ? el_wbdofs[ii] : el_ifdofs[ii];
+                  FlatArray<int> cols = (kind == INNERSOLVE) ? el_ifdofs[ii] :
+                    (kind == HARMONICEXT) ? el_wbdofs[ii] : el_ifdofs[ii];
+                  if (!rows.Size() || !cols.Size()) continue;
+
+                  VectorMem<100,TV> hx(cols.Size()), hy(rows.Size());
+                  hx = fx(cols);
+                  if (trans)
+                    hy = Trans (ElementMatrix (ii, HARMONICEXT)) * hx;
+                  else
+                    hy = ElementMatrix (ii, kind) * hx;
+                  for (int j = 0; j < rows.Size(); j++)
+                    fy(rows[j]) += hy(j);
+                }
+            }
+      }
+    }
+
+    void AddMatrix (FlatMatrix<SCAL> elmat, FlatArray<int> dnums, ElementId id, LocalHeap & lh)
 
     {
       static Timer timer ("BDDC - Addmatrix", 2);
@@ -242,6 +339,27 @@ namespace ngcomp
                << "schur = " << endl << a << endl;
       */
 
+      if (elementstorage)
+        {
+          int ii = ElementIndex (id);
+          if (wbdofs.Size() != el_wbdofs[ii].Size() || intdofs.Size() != el_ifdofs[ii].Size())
+            throw Exception ("BDDC: element dofs do not match the element tables");
+
+          // the element is in one color, nobody else writes its matrices
+          el_wbdofs[ii] = wbdofs;
+          el_ifdofs[ii] = intdofs;
+          for (int j = 0; j < intdofs.Size(); j++)
+            weight[intdofs[j]] += el2ifweight[j];
+
+          if (sizew) ElementMatrix (ii, HARMONICEXT) = he;
+          if (sizew && !bfa.IsSymmetric()) ElementMatrix (ii, HARMONICEXT_TRANS) = het;
+          ElementMatrix (ii, INNERSOLVE) = d;
+
+          dynamic_cast<SparseMatrix<SCAL,TV,TV>*>(pwbmat)
+            ->AddElementMatrix(wbdofs,wbdofs,a);
+          return;
+        }
+
       // critical can be removed when everything is colored
       // #pragma omp critical(bddcaddelmat)
       {
@@ -275,35 +393,65 @@ namespace ngcomp
       AllReduceDofData (weight, MPI_SUM, fes->GetParallelDofs());
 #endif
 
-      for (int i = 0; i < sparse_innersolve->Height(); i++)
-	{
-	  FlatArray<int> cols = sparse_innersolve -> GetRowIndices(i);
-	  for (int j = 0; j < cols.Size(); j++)
-	    if (weight[i] && weight[cols[j]])
-	      sparse_innersolve->GetRowValues(i)(j) /= (weight[i] * weight[cols[j]]);
-	}
-      
-      
-      for (int i = 0; i < sparse_harmonicext->Height(); i++)
-	if (weight[i])
-	  sparse_harmonicext->GetRowValues(i) /= weight[i];
-      
-      if (!bfa.IsSymmetric())
+      if (elementstorage)
         {
-          for (int i = 0; i < sparse_harmonicexttrans->Height(); i++)
+#pragma omp parallel for schedule(dynamic,10)
+          for (int ii = 0; ii < el_ifdofs.Size(); ii++)
             {
-              FlatArray<int> rowind = sparse_harmonicexttrans->GetRowIndices(i);
-              FlatVector<SCAL> values = sparse_harmonicexttrans->GetRowValues(i);
-              for (int j = 0; j < rowind.Size(); j++)
-                if (weight[rowind[j]])
-                  values[j] /= weight[rowind[j]];
+              FlatArray<int> ifdofs = el_ifdofs[ii];
+              FlatMatrix<SCAL> he = ElementMatrix (ii, HARMONICEXT);
+              FlatMatrix<SCAL> d = ElementMatrix (ii, INNERSOLVE);
+
+              for (int k = 0; k < ifdofs.Size(); k++)
+                if (weight[ifdofs[k]])
+                  {
+                    he.Row(k) /= weight[ifdofs[k]];
+                    for (int l = 0; l < ifdofs.Size(); l++)
+                      if (weight[ifdofs[l]])
+                        d(k,l) /= (weight[ifdofs[k]] * weight[ifdofs[l]]);
+                  }
+
+              if (!bfa.IsSymmetric())
+                {
+                  FlatMatrix<SCAL> het = ElementMatrix (ii, HARMONICEXT_TRANS);
+                  for (int l = 0; l < ifdofs.Size(); l++)
+                    if (weight[ifdofs[l]])
+                      het.Col(l) /= weight[ifdofs[l]];
+                }
             }
-          /*
-          // bug ! should be transposed !!!
-          for (int i = 0; i < sparse_harmonicexttrans->Height(); i++)
+        }
+      else
+        {
+          for (int i = 0; i < sparse_innersolve->Height(); i++)
+            {
+              FlatArray<int> cols = sparse_innersolve -> GetRowIndices(i);
+              for (int j = 0; j < cols.Size(); j++)
+                if (weight[i] && weight[cols[j]])
+                  sparse_innersolve->GetRowValues(i)(j) /= (weight[i] * weight[cols[j]]);
+            }
+
+
+          for (int i = 0; i < sparse_harmonicext->Height(); i++)
             if (weight[i])
-              sparse_harmonicexttrans->GetRowValues(i) /= weight[i];
-          */
+              sparse_harmonicext->GetRowValues(i) /= weight[i];
+
+          if (!bfa.IsSymmetric())
+            {
+              for (int i = 0; i < sparse_harmonicexttrans->Height(); i++)
+                {
+                  FlatArray<int> rowind = sparse_harmonicexttrans->GetRowIndices(i);
+                  FlatVector<SCAL> values = sparse_harmonicexttrans->GetRowValues(i);
+                  for (int j = 0; j < rowind.Size(); j++)
+                    if (weight[rowind[j]])
+                      values[j] /= weight[rowind[j]];
+                }
+              /*
+              // bug ! should be transposed !!!
+              for (int i = 0; i < sparse_harmonicexttrans->Height(); i++)
+                if (weight[i])
+                  sparse_harmonicexttrans->GetRowValues(i) /= weight[i];
+              */
+            }
         }
 
       // now generate wire-basked solver
@@ -362,6 +510,11 @@ namespace ngcomp
 	    {
 	      ParallelDofs * pardofs = &bfa.GetFESpace()->GetParallelDofs();
 
+	      if (coarsetype == "amg")
+		throw Exception ("BDDC: coarsetype=amg is not available for parallel spaces");
+	      if (elementstorage)
+		throw Exception ("BDDC: elementstorage is not available for parallel spaces");
+
 	      pwbmat = new ParallelMatrix (shared_ptr<BaseMatrix> (pwbmat, NOOP_Deleter), pardofs);
 	      pwbmat -> SetInverseType (inversetype);
 
@@ -384,7 +537,14 @@ namespace ngcomp
 	      cout << "call wirebasket inverse ( with " << cntfreedofs 
 		   << " free dofs out of " << pwbmat->Height() << " )" << endl;
 
-	      inv = pwbmat->InverseMatrix(free_dofs);
+	      if (coarsetype == "amg")
+		{
+		  auto amg = CreateAggregationAMG (*pwbmat, free_dofs);
+		  amg -> PrintReport (cout);
+		  inv = amg;
+		}
+	      else
+		inv = pwbmat->InverseMatrix(free_dofs);
 	      cout << "has inverse" << endl;
 	      tmp = new VVector<TV>(ndof);
 	    }
@@ -413,6 +573,26 @@ namespace ngcomp
     virtual int VHeight() const { return bfa.GetMatrix().VHeight(); }
     virtual int VWidth() const { return bfa.GetMatrix().VHeight(); }
 
+    virtual void MemoryUsage (Array<MemoryUsageStruct*> & mu) const
+    {
+      if (sparse_innersolve) sparse_innersolve -> MemoryUsage (mu);
+      if (sparse_harmonicext) sparse_harmonicext -> MemoryUsage (mu);
+      if (sparse_harmonicexttrans) sparse_harmonicexttrans -> MemoryUsage (mu);
+      if (elementstorage)
+        mu.Append (new MemoryUsageStruct ("BDDC element matrices",
+                                          elstorage.Size()*sizeof(SCAL) + eloffset.Size()*sizeof(size_t)
+                                          + (el_wbdofs.NElements()+el_ifdofs.NElements())*sizeof(int),
+                                          1));
+
+      // wirebasket matrix and its inverse (factor or AMG levels)
+      int olds = mu.Size();
+      if (pwbmat) pwbmat -> MemoryUsage (mu);
+      if (inv) inv -> MemoryUsage (mu);
+      if (inv_coarse) inv_coarse -> MemoryUsage (mu);
+      for (int i = olds; i < mu.Size(); i++)
+        mu[i]->AddName (" bddc coarse");
+    }
+
     
     virtual void MultAdd (double s, const BaseVector & x, BaseVector & y) const
     {
@@ -430,7 +610,9 @@ namespace ngcomp
 
       timerharmonicexttrans.Start();
 
-      if (bfa.IsSymmetric())
+      if (elementstorage)
+        MultAddElements (HARMONICEXT_TRANS, x.FV<TV>(), y.FV<TV>());
+      else if (bfa.IsSymmetric())
 	y += Transpose(*harmonicext) * x; 
       else
 	y += *harmonicexttrans * x;
@@ -462,13 +644,19 @@ namespace ngcomp
       timerwb.Stop();
 
       timerifs.Start();
-      *tmp += *innersolve * x;
+      if (elementstorage)
+        MultAddElements (INNERSOLVE, x.FV<TV>(), tmp->FV<TV>());
+      else
+        *tmp += *innersolve * x;
       timerifs.Stop();
 
       timerharmonicext.Start();
       
       y = *tmp;
-      y += *harmonicext * *tmp;
+      if (elementstorage)
+        MultAddElements (HARMONICEXT, tmp->FV<TV>(), y.FV<TV>());
+      else
+        y += *harmonicext * *tmp;
 
       timerharmonicext.Stop();
 
@@ -490,7 +678,8 @@ namespace ngcomp
     const S_BilinearForm<SCAL> * bfa;
     BDDCMatrix<SCAL,TV> * pre;
     string inversetype;
-    bool block, hypre;
+    string coarsetype;
+    bool block, hypre, elementstorage;
   public:
     BDDCPreconditioner (const PDE & pde, const Flags & aflags, const string & aname)
       : Preconditioner (&pde, aflags, aname)
@@ -498,9 +687,11 @@ namespace ngcomp
       bfa = dynamic_cast<const S_BilinearForm<SCAL>*>(pde.GetBilinearForm (aflags.GetStringFlag ("bilinearform")).get());
       const_cast<S_BilinearForm<SCAL>*> (bfa) -> SetPreconditioner (this);
       inversetype = flags.GetStringFlag("inverse", "sparsecholesky");
+      coarsetype = flags.GetStringFlag("coarsetype", "direct");
       if (flags.GetDefineFlag("refelement")) Exception ("refelement - BDDC not supported");
       block = flags.GetDefineFlag("block");
       hypre = flags.GetDefineFlag("usehypre");
+      elementstorage = flags.GetDefineFlag("elementstorage");
       pre = NULL;
     }
     
@@ -511,9 +702,11 @@ namespace ngcomp
       bfa = dynamic_cast<const S_BilinearForm<SCAL>*>(abfa.get());
       const_cast<S_BilinearForm<SCAL>*> (bfa) -> SetPreconditioner (this);
       inversetype = flags.GetStringFlag("inverse", "sparsecholesky");
+      coarsetype = flags.GetStringFlag("coarsetype", "direct");
       if (flags.GetDefineFlag("refelement")) Exception ("refelement - BDDC not supported");
       block = flags.GetDefineFlag("block");
       hypre = flags.GetDefineFlag("usehypre");
+      elementstorage = flags.GetDefineFlag("elementstorage");
       pre = NULL;
     }
 
@@ -526,7 +719,7 @@ namespace ngcomp
     virtual void InitLevel () 
     {
       delete pre;
-      pre = new BDDCMatrix<SCAL,TV>(*bfa, inversetype, block, hypre);
+      pre = new BDDCMatrix<SCAL,TV>(*bfa, inversetype, coarsetype, block, hypre, elementstorage);
       pre -> SetHypre (hypre);
     }
 
@@ -575,6 +768,11 @@ namespace ngcomp
     }
 
 
+    virtual void MemoryUsage (Array<MemoryUsageStruct*> & mu) const
+    {
+      if (pre) pre -> MemoryUsage (mu);
+    }
+
     virtual const char * ClassName() const
     { return "BDDC Preconditioner"; }
   };
@@ -607,7 +805,7 @@ namespace ngcomp
     helmat = elmat.Rows(compress).Cols(compress);
     
     if (L2Norm (helmat) != 0)
-      pre -> AddMatrix(helmat, hdnums, lh);
+      pre -> AddMatrix(helmat, hdnums, id, lh);
   }
   
 
@@ -82,6 +82,8 @@ namespace ngcomp
     checksum = flags.GetDefineFlag ("checksum");
     spd = flags.GetDefineFlag ("spd");
     if (spd) symmetric = true;
+    if (flags.NumFlagDefined ("geometrycache"))
+      ma->SetGeometryCache (size_t (1e6 * flags.GetNumFlag ("geometrycache", 0)));
   }
 
 
@@ -130,6 +132,8 @@ namespace ngcomp
 
     precompute = flags.GetDefineFlag ("precompute");
     checksum = flags.GetDefineFlag ("checksum");
+    if (flags.NumFlagDefined ("geometrycache"))
+      ma->SetGeometryCache (size_t (1e6 * flags.GetNumFlag ("geometrycache", 0)));
   }
 
 
@@ -483,7 +487,11 @@ namespace ngcomp
       }
 
 
+    double assemblestart = WallTime();
     DoAssemble(lh);
+    if (timing)
+      cout << " assembling takes " << WallTime()-assemblestart << " seconds, "
+           << "geometry cache " << ma->GetGeometryCacheBytes() << " bytes" << endl;
 
 
     if (timing)
@@ -542,7 +550,11 @@ namespace ngcomp
       }
 
     GetMatrix() = 0.0;
+    double assemblestart = WallTime();
     DoAssemble(lh);
+    if (timing)
+      cout << " reassembling takes " << WallTime()-assemblestart << " seconds, "
+           << "geometry cache " << ma->GetGeometryCacheBytes() << " bytes" << endl;
 
     if (galerkin)
       GalerkinProjection();
@@ -1236,7 +1248,7 @@ namespace ngcomp
 	    RegionTimer reg(mattimer2);
             if (hasskeletonbound)
               {
-                int cnt = 0;          
+                ProgressOutput progress (ma, "assemble facet surface element", nse);
 #pragma omp parallel
                 {
                   LocalHeap lh = clh.Split();
@@ -1245,15 +1257,7 @@ namespace ngcomp
 #pragma omp for 
                   for (int i = 0; i < nse; i++)
                     {
-#pragma omp critical(printmatasstatus2)
-                      {
-                        cnt++;
-                        gcnt++;
-                        if (cnt % 10 == 0)
-                          cout << "\rassemble facet surface element " << cnt << "/" << nse << flush;
-                        ma->SetThreadPercentage ( 100.0*(gcnt) / (loopsteps) );
-                      }
-                  
+                      progress.Update();
                       HeapReset hr(lh);
                       
                       if (!fespace->DefinedOnBoundary (ma->GetSElIndex (i))) continue;
@@ -1347,36 +1351,29 @@ namespace ngcomp
                         }//end for (numintegrators)
                     }//end for nse                  
                 }//end of parallel
-                cout << "\rassemble facet surface element " << nse << "/" << nse << endl;         
+                progress.Done();
+                gcnt += nse;
               }//end of hasskeletonbound
             if (hasskeletoninner)
               {
-                int dim = ma->GetDimension();
-                BitArray fine_facet(nf);
-                fine_facet.Clear();
-                Array<int> elfacets;
-                for (int i = 0; i < ne; ++i)
-                  {
-                    if(dim==2)
-                      ma->GetElEdges(i,elfacets);
-                    else
-                      ma->GetElFaces(i,elfacets);
-                    for (int j=0;j<elfacets.Size();j++)
-                      fine_facet.Set(elfacets[j]);
-                  }
+                // facets of one color couple disjoint sets of dofs,
+                // so their element matrices are added without locks
+                const Table<int> & facet_coloring = fespace->FacetColoring();
+                ProgressOutput progress (ma, "assemble inner facet element", nf);
 
-                int cnt = 0;
 #pragma omp parallel 
                 {
                   LocalHeap lh = clh.Split();
 
                   // ElementTransformation eltrans1, eltrans2;
                   Array<int> dnums, dnums1, dnums2, elnums, fnums, vnums1, vnums2;
-#pragma omp for 
-                  for (int i = 0; i < nf; i++)
+                  for (FlatArray<int> facets_of_col : facet_coloring)
+#pragma omp for schedule(dynamic)
+                  for (int ii = 0; ii < facets_of_col.Size(); ii++)
                     {
-                      if (!fine_facet.Test(i)) continue;
+                      int i = facets_of_col[ii];
                       HeapReset hr(lh);
+                      progress.Update();
                       
                       int el1 = -1;
                       int el2 = -1;
@@ -1396,16 +1393,6 @@ namespace ngcomp
                       ma->GetElFacets(el2,fnums);
                       for (int k=0; k<fnums.Size(); k++)
                         if(i==fnums[k]) facnr2 = k;
-                      
-#pragma omp critical(printmatasstatus2)
-                      {
-                        cnt++;
-                        gcnt++;
-                        if (cnt % 10 == 0)
-                          cout << "\rassemble inner facet element " << cnt << "/" << nf << flush;
-                        ma->SetThreadPercentage ( 100.0*(gcnt) / (loopsteps) );
-                      }
-                      
                   
                       const FiniteElement & fel1 = fespace->GetFE (el1, lh);
                       const FiniteElement & fel2 = fespace->GetFE (el2, lh);
@@ -1449,7 +1436,6 @@ namespace ngcomp
                             dynamic_cast<const FacetBilinearFormIntegrator&>(bfi);
                           fbfi.CalcFacetMatrix (fel1,facnr1,eltrans1,vnums1,
                                                 fel2,facnr2,eltrans2,vnums2, elmat, lh);
-                          *testout << "elmat : \n" << elmat << endl;
 
                           fespace->TransformMat (el1, false, elmat.Rows(0,dnums1.Size()), TRANSFORM_MAT_LEFT);
                           fespace->TransformMat (el2, false, elmat.Rows(dnums1.Size(),dnums2.Size()), TRANSFORM_MAT_LEFT);
@@ -1492,14 +1478,12 @@ namespace ngcomp
                           //                      if(fabs(elmat(k,k)) < 1e-7 && dnums[k] != -1)
                           //                        cout << "dnums " << dnums << " elmat " << elmat << endl; 
 
-#pragma omp critical(addelemfacin)
-                          {
-                            AddElementMatrix (dnums, dnums, elmat, ElementId(BND,i), lh);
-                          }
+                          AddElementMatrix (dnums, dnums, elmat, ElementId(BND,i), lh);
                         }
                     }
                 }
-                cout << "\rassemble inner facet element " << nf << "/" << nf << endl;     
+                progress.Done();
+                gcnt += nf;
               }
             ma->SetThreadPercentage ( 100.0 );
 
@@ -2421,6 +2405,7 @@ namespace ngcomp
     static Timer timer ("Apply Matrix");
     static Timer timervol ("Apply Matrix - volume");
     static Timer timerbound ("Apply Matrix - boundary");
+    static Timer timerfacet ("Apply Matrix - facets");
     RegionTimer reg (timer);
 
 
@@ -2514,7 +2499,122 @@ namespace ngcomp
                   }
 
                 if (hasskeletonbound||hasskeletoninner)
-                  throw Exception ("No BilinearFormApplication-Implementation for Facet-Integrators yet");
+                  {
+                    RegionTimer reg (timerfacet);
+
+#ifdef _OPENMP
+		    LocalHeap clh (lh_size*omp_get_max_threads(), "biform-AddMatrix - Heap");
+#else
+		    LocalHeap clh (lh_size, "biform-AddMatrix - Heap");
+#endif
+                    int dim = fespace->GetDimension();
+                    const Table<int> & facet_coloring = fespace->FacetColoring();
+
+#pragma omp parallel
+                    {
+                      LocalHeap lh = clh.Split();
+                      Array<int> elnums, selnums, fnums, vnums1, vnums2, dnums1, dnums2, dnums;
+
+                      for (FlatArray<int> facets_of_col : facet_coloring)
+
+#pragma omp for schedule(dynamic)
+                        for (int ii = 0; ii < facets_of_col.Size(); ii++)
+                          {
+                            HeapReset hr(lh);
+                            int fnr = facets_of_col[ii];
+                            
+                            ma->GetFacetElements (fnr, elnums);
+                            int el1 = elnums[0];
+                            int facnr1 = -1;
+                            ma->GetElFacets (el1, fnums);
+                            for (int k = 0; k < fnums.Size(); k++)
+                              if (fnr == fnums[k]) facnr1 = k;
+
+                            const FiniteElement & fel1 = fespace->GetFE (el1, lh);
+                            ElementTransformation & eltrans1 = ma->GetTrafo (el1, VOL, lh);
+                            fespace->GetDofNrs (el1, dnums1);
+                            ma->GetElVertices (el1, vnums1);
+                            int n1 = dnums1.Size()*dim;
+
+                            if (elnums.Size() == 2 && hasskeletoninner)
+                              {
+                                int el2 = elnums[1];
+                                int facnr2 = -1;
+                                ma->GetElFacets (el2, fnums);
+                                for (int k = 0; k < fnums.Size(); k++)
+                                  if (fnr == fnums[k]) facnr2 = k;
+
+                                const FiniteElement & fel2 = fespace->GetFE (el2, lh);
+                                ElementTransformation & eltrans2 = ma->GetTrafo (el2, VOL, lh);
+                                fespace->GetDofNrs (el2, dnums2);
+                                ma->GetElVertices (el2, vnums2);
+                                int n2 = dnums2.Size()*dim;
+
+                                dnums = dnums1;
+                                dnums.Append (dnums2);
+
+                                FlatVector<SCAL> elx(n1+n2, lh), ely(n1+n2, lh);
+                                x.GetIndirect (dnums, elx);
+                                fespace->TransformVec (el1, false, elx.Range(0,n1), TRANSFORM_SOL);
+                                fespace->TransformVec (el2, false, elx.Range(n1,n1+n2), TRANSFORM_SOL);
+
+                                for (int j = 0; j < NumIntegrators(); j++)
+                                  {
+                                    const BilinearFormIntegrator & bfi = *parts[j];
+                                    
+                                    if (!bfi.SkeletonForm()) continue;
+                                    if (bfi.BoundaryForm()) continue;
+                                    if (!bfi.DefinedOn (ma->GetElIndex (el1))) continue;
+                                    if (!bfi.DefinedOn (ma->GetElIndex (el2))) continue;
+
+                                    const FacetBilinearFormIntegrator & fbfi = 
+                                      dynamic_cast<const FacetBilinearFormIntegrator&>(bfi);
+                                    fbfi.ApplyFacetMatrix (fel1, facnr1, eltrans1, vnums1,
+                                                           fel2, facnr2, eltrans2, vnums2, elx, ely, lh);
+
+                                    fespace->TransformVec (el1, false, ely.Range(0,n1), TRANSFORM_RHS);
+                                    fespace->TransformVec (el2, false, ely.Range(n1,n1+n2), TRANSFORM_RHS);
+                                    ely *= val;
+                                    y.AddIndirect (dnums, ely);  // coloring
+                                  }
+                              }
+
+                            if (!hasskeletonbound) continue;
+
+                            // all surface elements, also on interfaces between two 
+                            // elements, from the first element as in DoAssemble
+                            ma->GetFacetSurfaceElements (fnr, selnums);
+                            for (int sel : selnums)
+                              {
+                                if (!fespace->DefinedOnBoundary (ma->GetSElIndex (sel))) continue;
+
+                                ElementTransformation & seltrans = ma->GetTrafo (sel, BND, lh);
+
+                                FlatVector<SCAL> elx(n1, lh), ely(n1, lh);
+                                x.GetIndirect (dnums1, elx);
+                                fespace->TransformVec (el1, false, elx, TRANSFORM_SOL);
+
+                                for (int j = 0; j < NumIntegrators(); j++)
+                                  {
+                                    const BilinearFormIntegrator & bfi = *parts[j];
+                                    
+                                    if (!bfi.SkeletonForm()) continue;
+                                    if (!bfi.BoundaryForm()) continue;
+                                    if (!bfi.DefinedOn (ma->GetSElIndex (sel))) continue;
+
+                                    const FacetBilinearFormIntegrator & fbfi = 
+                                      dynamic_cast<const FacetBilinearFormIntegrator&>(bfi);
+                                    fbfi.ApplyFacetMatrix (fel1, facnr1, eltrans1, vnums1,
+                                                           seltrans, elx, ely, lh);
+
+                                    fespace->TransformVec (el1, false, ely, TRANSFORM_RHS);
+                                    ely *= val;
+                                    y.AddIndirect (dnums1, ely);  // coloring
+                                  }
+                              }
+                          }
+                    }
+                  }
                   
                 if (fespace->specialelements.Size())
                   {
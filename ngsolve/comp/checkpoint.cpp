@@ -0,0 +1,532 @@
+/*********************************************************************/
+/* File:   checkpoint.cpp                                            */
+/* Date:   Oct. 2026                                                 */
+/*********************************************************************/
+
+/*
+   Binary checkpoints of grid-functions
+*/
+
+#include <comp.hpp>
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#ifdef USE_ZLIB
+#include <zlib.h>
+#endif
+
+
+namespace ngcomp
+{
+  static const char checkpoint_magic[8] = { 'N', 'G', 'S', 'C', 'H', 'K', 'P', 'T' };
+  static const int checkpoint_version = 1;
+  static const size_t checkpoint_align = 4096;
+  /// dofs per chunk
+  static const size_t checkpoint_chunksize = 1 << 18;
+
+
+  template <typename T>
+  static void Put (Array<char> & buf, const T & val)
+  {
+    const char * p = reinterpret_cast<const char*> (&val);
+    for (size_t i = 0; i < sizeof(T); i++)
+      buf.Append (p[i]);
+  }
+
+  static void Put (Array<char> & buf, const string & str)
+  {
+    Put (buf, int(str.length()));
+    for (char c : str) buf.Append (c);
+  }
+
+  template <typename T>
+  static T Get (const char * & p)
+  {
+    T val;
+    memcpy (&val, p, sizeof(T));
+    p += sizeof(T);
+    return val;
+  }
+
+  static string GetString (const char * & p)
+  {
+    int len = Get<int> (p);
+    string str(p, len);
+    p += len;
+    return str;
+  }
+
+  static size_t AlignUp (size_t offset)
+  {
+    return (offset + checkpoint_align-1) / checkpoint_align * checkpoint_align;
+  }
+
+
+  /**
+     Position of every dof if nodes are sorted by their vertices,
+     as in GridFunction::Save. Dofs without node come last.
+  */
+  static void CalcNodeSortedOrder (const FESpace & fes, Array<int> & order)
+  {
+    const MeshAccess & ma = *fes.GetMeshAccess();
+    int ndof = fes.GetNDof();
+    order.SetSize (ndof);
+    order = -1;
+
+    int pos = 0;
+    Array<int> dnums, pnums;
+    for (NODE_TYPE nt = NT_VERTEX; nt <= NT_CELL; nt++)
+      {
+        Array<Vec<8,int> > nodekeys;
+        Array<int> nodes;
+        for (int i = 0; i < ma.GetNNodes (nt); i++)
+          {
+            fes.GetNodeDofNrs (nt, i, dnums);
+            if (dnums.Size() == 0) continue;
+
+            switch (nt)
+              {
+              case NT_VERTEX: pnums.SetSize(1); pnums[0] = i; break;
+              case NT_EDGE: ma.GetEdgePNums (i, pnums); break;
+              case NT_FACE: ma.GetFacePNums (i, pnums); break;
+              case NT_CELL: ma.GetElPNums (i, pnums); break;
+              }
+            Vec<8,int> key = -1;
+            for (int j = 0; j < pnums.Size(); j++)
+              key[j] = pnums[j];
+            nodekeys.Append (key);
+            nodes.Append (i);
+          }
+
+        Array<int> index(nodes.Size());
+        for (int i = 0; i < index.Size(); i++) index[i] = i;
+        QuickSortI (nodekeys, index,
+                    [] (const Vec<8,int> & a, const Vec<8,int> & b)
+                    {
+                      for (int k = 0; k < 8; k++)
+                        {
+                          if (a[k] < b[k]) return true;
+                          if (a[k] > b[k]) return false;
+                        }
+                      return false;
+                    });
+
+        for (int i = 0; i < index.Size(); i++)
+          {
+            fes.GetNodeDofNrs (nt, nodes[index[i]], dnums);
+            for (int d : dnums)
+              if (d >= 0 && order[d] == -1)
+                order[d] = pos++;
+          }
+      }
+
+    for (int d = 0; d < ndof; d++)
+      if (order[d] == -1) order[d] = pos++;
+  }
+
+
+
+#ifndef WIN32
+
+  /// read-only file, mapped copy-on-write
+  class MappedFile
+  {
+    int fd;
+    size_t size;
+    char * data;
+  public:
+    MappedFile (const string & filename)
+    {
+      fd = open (filename.c_str(), O_RDONLY);
+      if (fd < 0)
+        throw Exception ("cannot open checkpoint '" + filename + "'");
+      struct stat st;
+      fstat (fd, &st);
+      size = st.st_size;
+      data = (char*) mmap (NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+      if (data == MAP_FAILED)
+        {
+          close (fd);
+          throw Exception ("cannot map checkpoint '" + filename + "'");
+        }
+    }
+
+    ~MappedFile ()
+    {
+      munmap (data, size);
+      close (fd);
+    }
+
+    char * Data () const { return data; }
+    size_t Size () const { return size; }
+  };
+
+  /// coefficient vector living in a mapped checkpoint
+  template <typename TSCAL>
+  class MappedVector : public S_BaseVectorPtr<TSCAL>
+  {
+    shared_ptr<MappedFile> file;
+  public:
+    MappedVector (int as, int aes, void * adata, shared_ptr<MappedFile> afile)
+      : S_BaseVectorPtr<TSCAL> (as, aes, adata), file(afile) { ; }
+  };
+
+
+  void SaveCheckpoint (const string & filename,
+                       FlatArray<shared_ptr<GridFunction>> gfs,
+                       bool compress, bool nodeorder)
+  {
+    static Timer t("SaveCheckpoint");
+    static Timer tc("SaveCheckpoint - compress");
+    static Timer tw("SaveCheckpoint - write");
+    RegionTimer reg(t);
+
+    if (MyMPI_GetNTasks() > 1)
+      throw Exception ("SaveCheckpoint: only for a single process");
+
+#ifndef USE_ZLIB
+    if (compress)
+      {
+        cout << IM(1) << "checkpoint compression needs zlib, writing uncompressed" << endl;
+        compress = false;
+      }
+#endif
+
+    // all chunks of all vectors
+    Array<const char*> chunk_data;
+    Array<size_t> chunk_raw, chunk_bytes, chunk_offset;
+    Array<int> first_chunk;   // per vector
+    Array<Array<int>> orders(gfs.Size());
+
+    for (int i = 0; i < gfs.Size(); i++)
+      {
+        if (!gfs[i]->IsUpdated())
+          throw Exception ("SaveCheckpoint: gridfunction '" + gfs[i]->GetName() + "' is not updated");
+        if (nodeorder)
+          CalcNodeSortedOrder (*gfs[i]->GetFESpace(), orders[i]);
+
+        for (int j = 0; j < gfs[i]->GetMultiDim(); j++)
+          {
+            const BaseVector & vec = gfs[i]->GetVector(j);
+            size_t dofbytes = vec.EntrySize() * sizeof(double);
+            const char * data = static_cast<const char*> (vec.Memory());
+
+            first_chunk.Append (chunk_raw.Size());
+            for (size_t first = 0; first < size_t(vec.Size()); first += checkpoint_chunksize)
+              {
+                size_t next = min2 (first+checkpoint_chunksize, size_t(vec.Size()));
+                chunk_data.Append (data + first*dofbytes);
+                chunk_raw.Append ((next-first)*dofbytes);
+              }
+          }
+      }
+    first_chunk.Append (chunk_raw.Size());
+    int nchunks = chunk_raw.Size();
+    chunk_bytes = chunk_raw;
+    chunk_offset.SetSize (nchunks);
+
+
+    // compress chunks in parallel, keep them raw if it does not pay
+    Array<Array<char>> packed(compress ? nchunks : 0);
+#ifdef USE_ZLIB
+    if (compress)
+      {
+        RegionTimer regc(tc);
+#pragma omp parallel for schedule(dynamic)
+        for (int c = 0; c < nchunks; c++)
+          {
+            uLongf len = compressBound (chunk_raw[c]);
+            packed[c].SetSize (len);
+            if (compress2 ((Bytef*)&packed[c][0], &len, (const Bytef*)chunk_data[c],
+                           chunk_raw[c], Z_BEST_SPEED) == Z_OK && len < chunk_raw[c])
+              {
+                chunk_bytes[c] = len;
+                chunk_data[c] = &packed[c][0];
+              }
+          }
+      }
+#endif
+
+
+    // the header has fixed size, data follow page aligned
+    Array<size_t> order_offset(gfs.Size());
+    auto write_header = [&] (Array<char> & buf)
+      {
+        buf.SetSize0();
+        for (char c : checkpoint_magic) buf.Append (c);
+        Put (buf, checkpoint_version);
+        Put (buf, int(gfs.Size()));
+
+        for (int i = 0, v = 0; i < gfs.Size(); i++)
+          {
+            const GridFunction & gf = *gfs[i];
+            const FESpace & fes = *gf.GetFESpace();
+            Put (buf, gf.GetName());
+            Put (buf, fes.GetClassName());
+            Put (buf, fes.GetOrder());
+            Put (buf, fes.GetDimension());
+            Put (buf, int(fes.IsComplex()));
+            Put (buf, gf.GetMultiDim());
+            Put (buf, size_t(fes.GetNDof()));
+            Put (buf, gf.GetVector().EntrySize());
+            Put (buf, order_offset[i]);
+            Put (buf, checkpoint_chunksize);
+            for (int j = 0; j < gf.GetMultiDim(); j++, v++)
+              {
+                Put (buf, first_chunk[v+1]-first_chunk[v]);
+                for (int c = first_chunk[v]; c < first_chunk[v+1]; c++)
+                  {
+                    Put (buf, chunk_offset[c]);
+                    Put (buf, chunk_raw[c]);
+                    Put (buf, chunk_bytes[c]);
+                  }
+              }
+          }
+      };
+
+    Array<char> header;
+    order_offset = 0;
+    chunk_offset = 0;
+    write_header (header);
+
+    // file layout: header, node orders, vectors
+    size_t offset = AlignUp (header.Size());
+    for (int i = 0; i < gfs.Size(); i++)
+      if (nodeorder)
+        {
+          order_offset[i] = offset;
+          offset = AlignUp (offset + orders[i].Size()*sizeof(int));
+        }
+    for (int v = 0; v+1 < first_chunk.Size(); v++)
+      {
+        for (int c = first_chunk[v]; c < first_chunk[v+1]; c++)
+          {
+            chunk_offset[c] = offset;
+            offset += chunk_bytes[c];
+          }
+        offset = AlignUp (offset);
+      }
+    size_t filesize = offset;
+
+    write_header (header);
+
+
+    RegionTimer regw(tw);
+    // write a new file and rename it, a loaded checkpoint may still be mapped
+    string tmpname = filename + ".tmp";
+    int fd = open (tmpname.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+      throw Exception ("cannot write checkpoint '" + filename + "'");
+    if (ftruncate (fd, filesize) != 0)
+      {
+        close (fd);
+        throw Exception ("cannot write checkpoint '" + filename + "'");
+      }
+
+    // pieces to write: header, node orders, chunks
+    Array<const char*> piece_data;
+    Array<size_t> piece_bytes, piece_offset;
+    piece_data.Append (&header[0]);
+    piece_bytes.Append (header.Size());
+    piece_offset.Append (0);
+    if (nodeorder)
+      for (int i = 0; i < gfs.Size(); i++)
+        {
+          piece_data.Append ((const char*)&orders[i][0]);
+          piece_bytes.Append (orders[i].Size()*sizeof(int));
+          piece_offset.Append (order_offset[i]);
+        }
+    piece_data.Append (chunk_data);
+    piece_bytes.Append (chunk_bytes);
+    piece_offset.Append (chunk_offset);
+
+    bool ok = true;
+#pragma omp parallel for schedule(dynamic)
+    for (int k = 0; k < piece_data.Size(); k++)
+      {
+        size_t done = 0;
+        while (done < piece_bytes[k])
+          {
+            ssize_t n = pwrite (fd, piece_data[k]+done, piece_bytes[k]-done, piece_offset[k]+done);
+            if (n <= 0) { ok = false; break; }
+            done += n;
+          }
+      }
+    close (fd);
+
+    if (!ok || rename (tmpname.c_str(), filename.c_str()) != 0)
+      throw Exception ("error writing checkpoint '" + filename + "'");
+  }
+
+
+
+  void LoadCheckpoint (const string & filename,
+                       FlatArray<shared_ptr<GridFunction>> gfs,
+                       bool mapped)
+  {
+    static Timer t("LoadCheckpoint");
+    RegionTimer reg(t);
+
+    if (MyMPI_GetNTasks() > 1)
+      throw Exception ("LoadCheckpoint: only for a single process");
+
+    auto file = make_shared<MappedFile> (filename);
+    const char * p = file->Data();
+
+    if (file->Size() < sizeof(checkpoint_magic) + 2*sizeof(int) ||
+        memcmp (p, checkpoint_magic, sizeof(checkpoint_magic)) != 0)
+      throw Exception ("'" + filename + "' is not a checkpoint");
+    p += sizeof(checkpoint_magic);
+    if (Get<int> (p) != checkpoint_version)
+      throw Exception ("'" + filename + "': unknown checkpoint version");
+
+    int ngf = Get<int> (p);
+    for (int i = 0; i < ngf; i++)
+      {
+        string name = GetString (p);
+        string fesclass = GetString (p);
+        int order = Get<int> (p);
+        int dim = Get<int> (p);
+        bool iscomplex = Get<int> (p);
+        int multidim = Get<int> (p);
+        size_t ndof = Get<size_t> (p);
+        int entrysize = Get<int> (p);
+        size_t order_offset = Get<size_t> (p);
+        Get<size_t> (p);    // chunk size
+
+        shared_ptr<GridFunction> gf;
+        for (auto gfi : gfs)
+          if (gfi->GetName() == name) gf = gfi;
+
+        // chunk table
+        Array<Array<size_t>> chunks(multidim);
+        for (int j = 0; j < multidim; j++)
+          {
+            int nchunks = Get<int> (p);
+            chunks[j].SetSize (3*nchunks);
+            for (size_t & c : chunks[j]) c = Get<size_t> (p);
+          }
+
+        if (!gf)
+          {
+            cerr << "LoadCheckpoint: gridfunction '" << name << "' not found, skipping" << endl;
+            continue;
+          }
+
+        cout << IM(1) << "Loading gridfunction " << name << endl;
+        gf->Update();
+        const FESpace & fes = *gf->GetFESpace();
+        if (fesclass != fes.GetClassName() || order != fes.GetOrder() ||
+            dim != fes.GetDimension() || iscomplex != fes.IsComplex() ||
+            ndof != size_t(fes.GetNDof()) || multidim != gf->GetMultiDim() ||
+            entrysize != gf->GetVector().EntrySize())
+          throw Exception ("LoadCheckpoint: gridfunction '" + name + "' does not match its space");
+
+        // same dof numbering as the saving process ?
+        Array<int> inv_perm;
+        if (order_offset)
+          {
+            Array<int> myorder;
+            CalcNodeSortedOrder (fes, myorder);
+            FlatArray<int> fileorder(ndof, (int*)(file->Data()+order_offset));
+
+            bool same = true;
+            for (size_t d = 0; d < ndof; d++)
+              if (myorder[d] != fileorder[d]) same = false;
+
+            if (!same)
+              {
+                // file dof of the position myorder[d]
+                Array<int> filedof(ndof);
+                for (size_t d = 0; d < ndof; d++)
+                  filedof[fileorder[d]] = d;
+                inv_perm.SetSize (ndof);
+                for (size_t d = 0; d < ndof; d++)
+                  inv_perm[d] = filedof[myorder[d]];
+              }
+          }
+
+        size_t dofbytes = entrysize * sizeof(double);
+        for (int j = 0; j < multidim; j++)
+          {
+            FlatArray<size_t> ch = chunks[j];
+            int nchunks = ch.Size()/3;
+            for (int c = 0; c < nchunks; c++)
+              if (ch[3*c] + ch[3*c+2] > file->Size())
+                throw Exception ("LoadCheckpoint: '" + filename + "' is truncated");
+
+            bool raw = true;
+            for (int c = 0; c < nchunks; c++)
+              if (ch[3*c+1] != ch[3*c+2]) raw = false;
+
+            if (mapped && raw && inv_perm.Size() == 0 && nchunks > 0)
+              {
+                // use the file in place
+                void * data = file->Data() + ch[0];
+                if (iscomplex)
+                  gf->SetVectorPtr (j, make_shared<MappedVector<Complex>> (ndof, entrysize/2, data, file));
+                else
+                  gf->SetVectorPtr (j, make_shared<MappedVector<double>> (ndof, entrysize, data, file));
+                continue;
+              }
+
+            Array<char> tmp(inv_perm.Size() ? ndof*dofbytes : 0);
+            char * dest = inv_perm.Size() ? &tmp[0] : static_cast<char*> (gf->GetVector(j).Memory());
+
+            bool ok = true;
+#pragma omp parallel for schedule(dynamic)
+            for (int c = 0; c < nchunks; c++)
+              {
+                const char * src = file->Data() + ch[3*c];
+                char * cdest = dest + size_t(c) * checkpoint_chunksize * dofbytes;
+                if (ch[3*c+1] == ch[3*c+2])
+                  memcpy (cdest, src, ch[3*c+1]);
+                else
+                  {
+#ifdef USE_ZLIB
+                    uLongf len = ch[3*c+1];
+                    if (uncompress ((Bytef*)cdest, &len, (const Bytef*)src, ch[3*c+2]) != Z_OK
+                        || len != ch[3*c+1])
+                      ok = false;
+#else
+                    ok = false;
+#endif
+                  }
+              }
+            if (!ok)
+              throw Exception ("LoadCheckpoint: cannot decompress '" + filename + "'");
+
+            if (inv_perm.Size())
+              {
+                char * vdata = static_cast<char*> (gf->GetVector(j).Memory());
+#pragma omp parallel for
+                for (size_t d = 0; d < ndof; d++)
+                  memcpy (vdata + d*dofbytes, &tmp[0] + inv_perm[d]*dofbytes, dofbytes);
+              }
+          }
+      }
+  }
+
+#else
+
+  void SaveCheckpoint (const string & filename,
+                       FlatArray<shared_ptr<GridFunction>> gfs,
+                       bool compress, bool nodeorder)
+  {
+    throw Exception ("SaveCheckpoint: not available on Windows");
+  }
+
+  void LoadCheckpoint (const string & filename,
+                       FlatArray<shared_ptr<GridFunction>> gfs,
+                       bool mapped)
+  {
+    throw Exception ("LoadCheckpoint: not available on Windows");
+  }
+
+#endif
+}
@@ -0,0 +1,42 @@
+#ifndef FILE_CHECKPOINT
+#define FILE_CHECKPOINT
+
+/*********************************************************************/
+/* File:   checkpoint.hpp                                            */
+/* Date:   Oct. 2026                                                 */
+/*********************************************************************/
+
+namespace ngcomp
+{
+
+  /**
+     Binary checkpoints of grid-functions.
+
+     The file starts with a header per grid-function (name, type and
+     order of the space, ndof, entry size) and a table of chunks. The
+     coefficient vectors follow in the dof numbering of the space, page
+     aligned. Chunks are written in parallel and can be compressed
+     with zlib, if NGSolve is configured with --enable-zlib.
+
+     With nodeorder, the position of every dof in the node-sorted order
+     of GridFunction::Save is stored as well, and vectors are permuted
+     on loading if the dof numbering has changed.
+
+     Loading maps the file into memory. Uncompressed vectors in the
+     same numbering are used in place (copy-on-write), without reading
+     them. Only for a single process.
+  */
+  extern NGS_DLL_HEADER
+  void SaveCheckpoint (const string & filename,
+                       FlatArray<shared_ptr<GridFunction>> gfs,
+                       bool compress = false, bool nodeorder = false);
+
+  /// grid-functions are matched by name, mapped = false always copies the vectors
+  extern NGS_DLL_HEADER
+  void LoadCheckpoint (const string & filename,
+                       FlatArray<shared_ptr<GridFunction>> gfs,
+                       bool mapped = true);
+
+}
+
+#endif
@@ -54,6 +54,7 @@ namespace ngcomp
 #include "fespace.hpp"
 
 #include "gridfunction.hpp"
+#include "checkpoint.hpp"
 #include "bilinearform.hpp"
 #include "linearform.hpp"
 #include "preconditioner.hpp"
@@ -232,6 +232,7 @@ lot of new non-zero entries in the matrix!\n" << endl;
 
     // element_coloring = NULL;
     // selement_coloring = NULL;
+    facet_coloring_valid = false;
     paralleldofs = NULL;
 
     ctofdof.SetSize(0);
@@ -459,9 +460,45 @@ lot of new non-zero entries in the matrix!\n" << endl;
         if (print)
           *testout << "needed " << maxcolor+1 << " colors" 
                    << " for " << ((vb == VOL) ? "vol" : "bnd") << endl;
+
+
+        // dependency graph: elements sharing a dof are chained in color order
+        Array<int> & npreds = (vb == VOL) ? element_npreds : selement_npreds;
+        npreds.SetSize (ma->GetNE(vb));
+        npreds = 0;
+        Array<int> last(GetNDof());
+        last = -1;
+        Array<int> preds, dnums;
+
+        TableCreator<int> creator(ma->GetNE(vb));
+        for ( ; !creator.Done(); creator++)
+          {
+            last = -1;
+            for (FlatArray<int> els_of_col : coloring)
+              for (int elnr : els_of_col)
+                {
+                  preds.SetSize0();
+                  GetDofNrs (ElementId(vb, elnr), dnums);
+                  for (auto d : dnums)
+                    if (d != -1)
+                      {
+                        if (last[d] != -1 && !preds.Contains (last[d]))
+                          {
+                            preds.Append (last[d]);
+                            creator.Add (last[d], elnr);
+                          }
+                        last[d] = elnr;
+                      }
+                  npreds[elnr] = preds.Size();
+                }
+          }
+        Table<int> & deps = (vb == VOL) ? element_dependencies : selement_dependencies;
+        deps = creator.MoveTable();
       }
 
 
+    facet_coloring_valid = false;
+
     level_updated = ma->GetNLevels();
     if (timing) Timing();
 
@@ -469,6 +506,128 @@ lot of new non-zero entries in the matrix!\n" << endl;
   }
 
 
+  // elements not in the definedon domains are not colored
+  static int NumColoredElements (const FESpace & fes, VorB vb)
+  {
+    int cnt = 0;
+    for (FlatArray<int> els_of_col : fes.ElementColoring(vb))
+      cnt += els_of_col.Size();
+    return cnt;
+  }
+
+  ElementTaskQueue :: ElementTaskQueue (const FESpace & fes, VorB vb)
+    : successors(fes.ElementDependencies(vb)),
+      npreds(fes.ElementNPredecessors(vb).Size()),
+      queue(NumColoredElements(fes, vb)),
+      wr(0), rd(0)
+  {
+    FlatArray<int> cntpreds = fes.ElementNPredecessors(vb);
+    for (int i : Range(npreds))
+      npreds[i] = cntpreds[i];
+    for (int i : Range(queue))
+      queue[i] = -1;
+    // start with independent elements, lowest colors first
+    for (FlatArray<int> els_of_col : fes.ElementColoring(vb))
+      for (int el : els_of_col)
+        if (cntpreds[el] == 0) Push (el);
+  }
+
+
+  const Table<int> & FESpace :: FacetColoring() const
+  {
+    if (facet_coloring_valid) return facet_coloring;
+
+    static Timer timer ("FESpace::FacetColoring");
+    RegionTimer reg (timer);
+
+    int nf = ma->GetNFacets();
+
+    // facets of the finest level only
+    BitArray fine_facet(nf);
+    fine_facet.Clear();
+    Array<int> elfacets;
+    for (int i = 0; i < ma->GetNE(); i++)
+      {
+        ma->GetElFacets (i, elfacets);
+        for (int f : elfacets)
+          fine_facet.Set(f);
+      }
+
+    Array<int> col(nf);
+    col = -1;
+    int maxcolor = 0;
+    int basecol = 0;
+    Array<unsigned int> mask(GetNDof());
+    Array<int> elnums, dnums;
+
+    int cnt = 0, found = 0;
+    for (int f = 0; f < nf; f++)
+      if (fine_facet.Test(f)) cnt++;
+
+    do
+      {
+        mask = 0;
+
+        for (int f = 0; f < nf; f++)
+          {
+            if (!fine_facet.Test(f) || col[f] >= 0) continue;
+
+            ma->GetFacetElements (f, elnums);
+            unsigned check = 0;
+            for (int el : elnums)
+              {
+                GetDofNrs (el, dnums);
+                for (int d : dnums)
+                  if (d != -1) check |= mask[d];
+              }
+
+            if (check != UINT_MAX)
+              {
+                found++;
+                unsigned checkbit = 1;
+                int color = basecol;
+                while (check & checkbit)
+                  {
+                    color++;
+                    checkbit *= 2;
+                  }
+
+                col[f] = color;
+                if (color > maxcolor) maxcolor = color;
+
+                for (int el : elnums)
+                  {
+                    GetDofNrs (el, dnums);
+                    for (int d : dnums)
+                      if (d != -1) mask[d] |= checkbit;
+                  }
+              }
+          }
+
+        basecol += 8*sizeof(unsigned int);
+      }
+    while (found < cnt);
+
+    Array<int> cntcol(maxcolor+1);
+    cntcol = 0;
+    for (int f = 0; f < nf; f++)
+      if (col[f] >= 0) cntcol[col[f]]++;
+
+    facet_coloring = Table<int> (cntcol);
+
+    cntcol = 0;
+    for (int f = 0; f < nf; f++)
+      if (col[f] >= 0)
+        facet_coloring[col[f]][cntcol[col[f]]++] = f;
+
+    if (print)
+      *testout << "needed " << maxcolor+1 << " colors for facets" << endl;
+
+    facet_coloring_valid = true;
+    return facet_coloring;
+  }
+
+
   const FiniteElement & FESpace :: GetFE (int elnr, LocalHeap & lh) const
   {
     FiniteElement * fe = NULL;
@@ -157,6 +157,14 @@ namespace ngcomp
 
     Table<int> element_coloring; 
     Table<int> selement_coloring;
+    /// successors of elements sharing dofs, ordered by color
+    Table<int> element_dependencies;
+    Table<int> selement_dependencies;
+    Array<int> element_npreds;
+    Array<int> selement_npreds;
+    /// computed on demand by FacetColoring()
+    mutable Table<int> facet_coloring;
+    mutable bool facet_coloring_valid;
     Array<COUPLING_TYPE> ctofdof;
 
     ParallelDofs * paralleldofs; // = NULL;
@@ -190,6 +198,17 @@ namespace ngcomp
     const Table<int> & ElementColoring(VorB vb = VOL) const 
     { return (vb == VOL) ? element_coloring : selement_coloring; }
 
+    /// elements sharing a dof with el, and colored later than el
+    const Table<int> & ElementDependencies(VorB vb = VOL) const 
+    { return (vb == VOL) ? element_dependencies : selement_dependencies; }
+
+    /// number of elements an element has to wait for
+    FlatArray<int> ElementNPredecessors(VorB vb = VOL) const 
+    { return (vb == VOL) ? element_npreds : selement_npreds; }
+
+    /// facets of one color share no dofs of their neighbouring elements
+    const Table<int> & FacetColoring() const;
+
     /// print report to stream
     virtual void PrintReport (ostream & ost) const;
 
@@ -591,30 +610,80 @@ namespace ngcomp
 
 
 
+  /**
+     Hands out elements as soon as all elements sharing dofs with them
+     and of lower color are finished. No barriers between colors.
+   */
+  class ElementTaskQueue
+  {
+    const Table<int> & successors;
+    Array<atomic<int>> npreds;
+    Array<atomic<int>> queue;
+    atomic<int> wr, rd;
+  public:
+    NGS_DLL_HEADER ElementTaskQueue (const FESpace & fes, VorB vb);
+
+    /// next element, -1 if all colored elements are handed out
+    int Pop ()
+    {
+      int pos = rd++;
+      if (pos >= queue.Size()) return -1;
+      int el, spin = 1;
+      while ( (el = queue[pos]) == -1)
+        {
+          // exponential backoff while the predecessors are computed
+          for (int i = 0; i < spin; i++) Pause();
+          if (spin < 1024) spin *= 2;
+        }
+      return el;
+    }
+
+    /// element el is finished, release waiting elements
+    void Done (int el)
+    {
+      for (int succ : successors[el])
+        if (--npreds[succ] == 0)
+          Push (succ);
+    }
+
+  private:
+    void Push (int el) { queue[wr++] = el; }
+
+    static void Pause ()
+    {
+#ifdef NGS_HAVE_RDTSC
+      _mm_pause();
+#endif
+    }
+  };
+
+
   template <typename TFUNC>
   inline void IterateElements (const FESpace & fes, 
                                VorB vb, 
                                LocalHeap & clh, 
                                const TFUNC & func)
   {
-    const Table<int> & element_coloring = fes.ElementColoring(vb);
+    static Timer timerthread("IterateElements - one thread");
+    ElementTaskQueue tasks(fes, vb);
     
 #pragma omp parallel 
     {
+      RegionTimer reg(timerthread);
       LocalHeap lh = clh.Split();
       Array<int> temp_dnums;
 
       // lh.ClearValues();
 
-      for (FlatArray<int> els_of_col : element_coloring)
-
-#pragma omp for schedule(dynamic)
-        for (int i = 0; i < els_of_col.Size(); i++)
+      for (int elnr = tasks.Pop(); elnr != -1; elnr = tasks.Pop())
+        {
           {
             HeapReset hr(lh);
-            FESpace::Element el(fes, ElementId (vb, els_of_col[i]), temp_dnums);
-              func (el, lh);
+            FESpace::Element el(fes, ElementId (vb, elnr), temp_dnums);
+            func (el, lh);
           }
+          tasks.Done (elnr);
+        }
       // cout << "lh, used size = " << lh.UsedSize() << endl;
     }
   }
@@ -194,6 +194,16 @@ namespace ngcomp
 
 
 
+  void GridFunction :: SetVectorPtr (int comp, shared_ptr<BaseVector> avec)
+  {
+    if (avec->Size() != vec[comp]->Size() || avec->EntrySize() != vec[comp]->EntrySize())
+      throw Exception ("GridFunction::SetVectorPtr: vector does not match");
+    vec[comp] = avec;
+    for (int i = 0; i < compgfs.Size(); i++)
+      compgfs[i]->Update();
+  }
+
+
   void GridFunction :: AddMultiDimComponent (BaseVector & v)
   {
     vec.SetSize (vec.Size()+1);
@@ -264,6 +274,84 @@ namespace ngcomp
   }
 
 
+  template <typename SCAL>
+  static void T_Evaluate (const GridFunction & gf, FlatMatrix<double> points,
+                          FlatMatrix<SCAL> values, LocalHeap & lh)
+  {
+    static Timer t("GridFunction::Evaluate");
+    RegionTimer reg(t);
+
+    shared_ptr<FESpace> fes = gf.GetFESpace();
+    shared_ptr<MeshAccess> ma = fes->GetMeshAccess();
+    shared_ptr<DifferentialOperator> evaluator = fes->GetEvaluator();
+    int np = points.Height();
+
+    if (values.Height() != np || values.Width() != evaluator->Dim())
+      throw Exception ("GridFunction::Evaluate: values must be " + ToString(np) 
+                       + " x " + ToString(evaluator->Dim()));
+
+    Array<int> elnrs(np);
+    Array<IntegrationPoint> ips(np);
+    ma->FindElementsOfPoints (points, elnrs, ips, lh);
+
+    // points sorted by element
+    TableCreator<int> creator(ma->GetNE());
+    for ( ; !creator.Done(); creator++)
+      for (int i = 0; i < np; i++)
+        {
+          if (elnrs[i] == -1)
+            throw Exception ("GridFunction::Evaluate: point " + ToString(i) + " out of domain");
+          creator.Add (elnrs[i], i);
+        }
+    Table<int> elpoints = creator.MoveTable();
+
+    Array<int> usedels;
+    for (int i = 0; i < elpoints.Size(); i++)
+      if (elpoints[i].Size()) usedels.Append (i);
+
+#pragma omp parallel
+    {
+      LocalHeap & clh = lh, lh = clh.Split();
+      Array<int> dnums;
+#pragma omp for schedule(dynamic)
+      for (int k = 0; k < usedels.Size(); k++)
+        {
+          HeapReset hr(lh);
+          int elnr = usedels[k];
+          FlatArray<int> pnums = elpoints[elnr];
+
+          const FiniteElement & fel = fes->GetFE (elnr, lh);
+          fes->GetDofNrs (elnr, dnums);
+          FlatVector<SCAL> elvec(fel.GetNDof()*fes->GetDimension(), lh);
+          gf.GetElementVector (dnums, elvec);
+
+          IntegrationRule ir(pnums.Size(), lh);
+          for (int j = 0; j < pnums.Size(); j++)
+            ir[j] = ips[pnums[j]];
+          
+          ElementTransformation & trafo = ma->GetTrafo (elnr, false, lh);
+          FlatMatrix<SCAL> elvalues(pnums.Size(), evaluator->Dim(), lh);
+          evaluator->Apply (fel, trafo(ir, lh), elvec, elvalues, lh);
+
+          for (int j = 0; j < pnums.Size(); j++)
+            values.Row(pnums[j]) = elvalues.Row(j);
+        }
+    }
+  }
+
+  void GridFunction :: Evaluate (FlatMatrix<double> points, FlatMatrix<double> values, 
+                                 LocalHeap & lh) const
+  {
+    T_Evaluate (*this, points, values, lh);
+  }
+
+  void GridFunction :: Evaluate (FlatMatrix<double> points, FlatMatrix<Complex> values, 
+                                 LocalHeap & lh) const
+  {
+    T_Evaluate (*this, points, values, lh);
+  }
+
+
 
 
 
@@ -50,6 +50,8 @@ namespace ngcomp
     virtual const BaseVector & GetVector (int comp = 0) const  { return *vec[comp]; }
     ///  
     virtual shared_ptr<BaseVector> GetVectorPtr (int comp = 0) const  { return vec[comp]; }
+    /// replaces a coefficient vector of the same size, e.g. by a memory-mapped one
+    void SetVectorPtr (int comp, shared_ptr<BaseVector> avec);
     ///
     void SetNested (int anested = 1) { nested = anested; }
     ///
@@ -144,6 +146,16 @@ namespace ngcomp
     { vec[comp] -> SetIndirect (dnums, elvec); }
 
 
+    /**
+       Evaluates the function in many points at once, in parallel.
+       The points are located by MeshAccess::FindElementsOfPoints, and all
+       points in one element are evaluated by one call of the evaluator.
+       values is (number of points) x (dimension of the evaluator).
+    */
+    void Evaluate (FlatMatrix<double> points, FlatMatrix<double> values, LocalHeap & lh) const;
+    ///
+    void Evaluate (FlatMatrix<double> points, FlatMatrix<Complex> values, LocalHeap & lh) const;
+
 
     virtual void Load (istream & ist) = 0;
     virtual void Save (ostream & ost) const = 0;
@@ -139,6 +139,13 @@ namespace ngcomp
       // static Timer t("eltrans::multipointjacobian"); RegionTimer reg(t);
       MappedIntegrationRule<DIMS,DIMR> & mir = 
 	static_cast<MappedIntegrationRule<DIMS,DIMR> &> (bmir);
+
+      if (mesh->GetCachedGeometry (Boundary(), elnr, ir, mir.GetPointsSoA(), mir.GetJacobianSoA()))
+        {
+          mir.ComputeSoA();
+          return;
+        }
+
       mesh->mesh.MultiElementTransformation <DIMS,DIMR> (elnr, ir.Size(),
                                                          &ir[0](0), &ir[1](0)-&ir[0](0),
                                                          &mir[0].Point()(0), 
@@ -146,8 +153,8 @@ namespace ngcomp
                                                          &mir[0].Jacobian()(0,0), 
                                                          &mir[1].Jacobian()(0,0)-&mir[0].Jacobian()(0,0));
     
-      for (int i = 0; i < ir.Size(); i++)
-        mir[i].Compute();
+      mir.ComputeSoAFromPoints();
+      mesh->CacheGeometry (Boundary(), elnr, ir, mir.GetPointsSoA(), mir.GetJacobianSoA());
   }
 };
   
@@ -251,10 +258,8 @@ namespace ngcomp
 	static_cast<MappedIntegrationRule<DIMS,DIMR> &> (bmir);
 
       for (int i = 0; i < ir.Size(); i++)
-        {
-          CalcPointJacobian (ir[i], mir[i].Point(), mir[i].Jacobian());
-          mir[i].Compute();
-        }
+        CalcPointJacobian (ir[i], mir[i].Point(), mir[i].Jacobian());
+      mir.ComputeSoAFromPoints();
 
       /*
       MappedIntegrationRule<DIMS,DIMR> & mir = 
@@ -415,13 +420,20 @@ namespace ngcomp
 					 BaseMappedIntegrationRule & bmir) const
     {
       MappedIntegrationRule<DIMS,DIMR> & mir = static_cast<MappedIntegrationRule<DIMS,DIMR> &> (bmir);
-      for (int i = 0; i < ir.Size(); i++)
+      SliceMatrix<> points = mir.GetPointsSoA();
+      SliceMatrix<> jac = mir.GetJacobianSoA();
+      for (int i = 0; i < DIMR; i++)
         {
-          const IntegrationPoint & ip = ir[i];
-          mir[i].Point() = p0 + mat * FlatVec<DIMS, const double> (&ip(0));
-          mir[i].Jacobian() = mat;
-          mir[i].Compute();
+          points.Row(i) = p0(i);
+          for (int k = 0; k < DIMS; k++)
+            {
+              double mik = mat(i,k);
+              for (int j = 0; j < ir.Size(); j++)
+                points(i,j) += mik * ir[j](k);
+              jac.Row(i*DIMS+k) = mik;
+            }
         }
+      mir.ComputeSoA();
     }
   };
   
@@ -454,6 +466,7 @@ namespace ngcomp
 
   MeshAccess :: ~MeshAccess ()
   {
+    delete geometrycache;
     // delete mesh;
     // Ng_LoadGeometry("");
   }
@@ -501,6 +514,8 @@ namespace ngcomp
 
   void MeshAccess :: UpdateBuffers()
   {
+    searchgrid_valid = false;
+
     if (!mesh.Valid())
       {
         for (int i = 0; i < 4; i++)  
@@ -512,6 +527,7 @@ namespace ngcomp
           }
         dim = -1;
         ne_vb[VOL] = ne_vb[BND] = 0;
+        ClearGeometryCache();
         return;
       }
 
@@ -545,6 +561,8 @@ namespace ngcomp
         ne_vb[BND] = nelements_cd[1];
       }
 
+    ClearGeometryCache();
+
     ndomains = -1;
     int ne = GetNE(); 
     for (int i = 0; i < ne; i++)
@@ -1164,6 +1182,379 @@ namespace ngcomp
   }
 
 
+  void MeshAccess :: BuildSearchGrid (LocalHeap & lh) const
+  {
+    static Timer t("MeshAccess::BuildSearchGrid");
+    RegionTimer reg(t);
+
+    int ne = GetNE();
+    searchgrid_elmin.SetSize (ne);
+    searchgrid_elmax.SetSize (ne);
+
+#pragma omp parallel
+    {
+      LocalHeap & clh = lh, lh = clh.Split();
+#pragma omp for
+      for (int i = 0; i < ne; i++)
+        {
+          HeapReset hr(lh);
+          Vec<3> pmin = 1e99, pmax = -1e99;
+          Vec<3> p = 0.0;
+
+          Ngs_Element ngel = GetElement (ElementId(VOL, i));
+          for (int v : ngel.Vertices())
+            {
+              auto pt = mesh.GetPoint (v);
+              for (int j = 0; j < dim; j++) p(j) = pt[j];
+              for (int j = 0; j < 3; j++)
+                {
+                  pmin(j) = min2 (pmin(j), p(j));
+                  pmax(j) = max2 (pmax(j), p(j));
+                }
+            }
+
+          // curved or deformed elements: sample the mapping, and add a safety margin
+          if (deformation || IsElementCurved (i))
+            {
+              ElementTransformation & trafo = GetTrafo (i, false, lh);
+              IntegrationRule ir(ngel.GetType(), 4);
+              FlatVector<> fp(dim, &p(0));
+              for (int k = 0; k < ir.Size(); k++)
+                {
+                  trafo.CalcPoint (ir[k], fp);
+                  for (int j = 0; j < 3; j++)
+                    {
+                      pmin(j) = min2 (pmin(j), p(j));
+                      pmax(j) = max2 (pmax(j), p(j));
+                    }
+                }
+              Vec<3> margin = 0.1 * (pmax-pmin);
+              pmin -= margin;
+              pmax += margin;
+            }
+
+          searchgrid_elmin[i] = pmin;
+          searchgrid_elmax[i] = pmax;
+        }
+    }
+
+    Vec<3> & gmin = searchgrid_pmin;
+    Vec<3> & gmax = searchgrid_pmax;
+    gmin = 1e99; gmax = -1e99;
+    for (int i = 0; i < ne; i++)
+      for (int j = 0; j < 3; j++)
+        {
+          gmin(j) = min2 (gmin(j), searchgrid_elmin[i](j));
+          gmax(j) = max2 (gmax(j), searchgrid_elmax[i](j));
+        }
+    if (ne == 0) gmin = gmax = 0.0;
+
+    // about one cell per element, cells as cubic as possible
+    double vol = 1;
+    for (int j = 0; j < dim; j++)
+      vol *= max2 (gmax(j)-gmin(j), 1e-14);
+    double h = pow (vol / max2 (ne, 1), 1.0/dim);
+    for (int j = 0; j < 3; j++)
+      {
+        double ext = gmax(j)-gmin(j);
+        searchgrid_n[j] = (j < dim) ? max2 (1, min2 (int(ext/h)+1, 1000)) : 1;
+        searchgrid_h[j] = max2 (ext / searchgrid_n[j], 1e-14);
+      }
+
+    int ncells = searchgrid_n[0] * searchgrid_n[1] * searchgrid_n[2];
+    TableCreator<int> creator(ncells);
+    for ( ; !creator.Done(); creator++)
+      for (int i = 0; i < ne; i++)
+        {
+          int lo[3], hi[3];
+          for (int j = 0; j < 3; j++)
+            {
+              lo[j] = max2 (0, int((searchgrid_elmin[i](j)-gmin(j)) / searchgrid_h(j)));
+              hi[j] = min2 (searchgrid_n[j]-1, int((searchgrid_elmax[i](j)-gmin(j)) / searchgrid_h(j)));
+            }
+          for (int iz = lo[2]; iz <= hi[2]; iz++)
+            for (int iy = lo[1]; iy <= hi[1]; iy++)
+              for (int ix = lo[0]; ix <= hi[0]; ix++)
+                creator.Add (ix + searchgrid_n[0] * (iy + searchgrid_n[1] * iz), i);
+        }
+    searchgrid = creator.MoveTable();
+    searchgrid_valid = true;
+  }
+
+
+  /// is the point inside of the reference element, up to eps ?
+  static bool InsideReferenceElement (ELEMENT_TYPE et, const IntegrationPoint & ip, double eps)
+  {
+    double x = ip(0), y = ip(1), z = ip(2);
+    switch (et)
+      {
+      case ET_TRIG:
+        return x >= -eps && y >= -eps && x+y <= 1+eps;
+      case ET_QUAD:
+        return x >= -eps && y >= -eps && x <= 1+eps && y <= 1+eps;
+      case ET_TET:
+        return x >= -eps && y >= -eps && z >= -eps && x+y+z <= 1+eps;
+      case ET_PRISM:
+        return x >= -eps && y >= -eps && x+y <= 1+eps && z >= -eps && z <= 1+eps;
+      case ET_PYRAMID:
+        return z >= -eps && z <= 1+eps && x >= -eps && y >= -eps
+          && x <= 1-z+eps && y <= 1-z+eps;
+      case ET_HEX:
+        return x >= -eps && y >= -eps && z >= -eps 
+          && x <= 1+eps && y <= 1+eps && z <= 1+eps;
+      default:
+        return false;
+      }
+  }
+
+  /// Newton's method for the reference coordinates of point p
+  template <int D>
+  static bool MapBackPoint (const ElementTransformation & trafo,
+                            const Vec<D> & p, IntegrationPoint & ip)
+  {
+    // start in the center of the element
+    switch (trafo.GetElementType())
+      {
+      case ET_TRIG: case ET_PRISM: ip = IntegrationPoint (1.0/3, 1.0/3, 0.5); break;
+      case ET_TET: ip = IntegrationPoint (0.25, 0.25, 0.25); break;
+      case ET_PYRAMID: ip = IntegrationPoint (0.4, 0.4, 0.2); break;
+      default: ip = IntegrationPoint (0.5, 0.5, 0.5); 
+      }
+
+    Vec<D> x;
+    Mat<D,D> jac;
+    for (int it = 0; it < 20; it++)
+      {
+        trafo.CalcPointJacobian (ip, x, jac);
+        Vec<D> dxi = Inv (jac) * (x-p);
+        double err = 0;
+        for (int j = 0; j < D; j++)
+          {
+            ip(j) -= dxi(j);
+            err += sqr (dxi(j));
+            if (fabs (ip(j)) > 10) return false;
+          }
+        if (err < 1e-24) break;
+      }
+    return InsideReferenceElement (trafo.GetElementType(), ip, 1e-8);
+  }
+
+  template <int D>
+  static void T_FindElementsOfPoints (const MeshAccess & ma, 
+                                      FlatMatrix<double> points,
+                                      FlatArray<int> elnrs,
+                                      FlatArray<IntegrationPoint> ips,
+                                      const Table<int> & grid,
+                                      FlatArray<Vec<3>> elmin, FlatArray<Vec<3>> elmax,
+                                      Vec<3> gmin, Vec<3> gmax, Vec<3> h, const int * n,
+                                      LocalHeap & lh)
+  {
+#pragma omp parallel
+    {
+      LocalHeap & clh = lh, lh = clh.Split();
+#pragma omp for schedule(dynamic, 64)
+      for (int i = 0; i < points.Height(); i++)
+        {
+          elnrs[i] = -1;
+          Vec<D> p;
+          for (int j = 0; j < D; j++) p(j) = points(i,j);
+
+          int ind[3] = { 0, 0, 0 };
+          bool outside = false;
+          for (int j = 0; j < D; j++)
+            {
+              double tol = 1e-8 * (gmax(j)-gmin(j)+h(j));
+              if (p(j) < gmin(j)-tol || p(j) > gmax(j)+tol) outside = true;
+              ind[j] = max2 (0, min2 (n[j]-1, int((p(j)-gmin(j)) / h(j))));
+            }
+          if (outside) continue;
+
+          for (int el : grid[ind[0] + n[0] * (ind[1] + n[1] * ind[2])])
+            {
+              bool inbox = true;
+              for (int j = 0; j < D; j++)
+                {
+                  double tol = 1e-8 * (elmax[el](j)-elmin[el](j));
+                  if (p(j) < elmin[el](j)-tol || p(j) > elmax[el](j)+tol) inbox = false;
+                }
+              if (!inbox) continue;
+
+              HeapReset hr(lh);
+              ElementTransformation & trafo = ma.GetTrafo (el, false, lh);
+              if (MapBackPoint<D> (trafo, p, ips[i]))
+                {
+                  elnrs[i] = el;
+                  break;
+                }
+            }
+        }
+    }
+  }
+
+
+  void MeshAccess :: FindElementsOfPoints (FlatMatrix<double> points,
+                                           FlatArray<int> elnrs,
+                                           FlatArray<IntegrationPoint> ips,
+                                           LocalHeap & lh) const
+  {
+    static Timer t("MeshAccess::FindElementsOfPoints");
+    RegionTimer reg(t);
+
+    if (points.Width() < dim)
+      throw Exception ("FindElementsOfPoints: need " + ToString(dim) + " coordinates per point");
+
+    // concurrent callers build the grid only once
+    if (!searchgrid_valid) 
+#pragma omp critical (buildsearchgrid)
+      {
+        if (!searchgrid_valid)
+          BuildSearchGrid (lh);
+      }
+
+    switch (dim)
+      {
+      case 2:
+        T_FindElementsOfPoints<2> (*this, points, elnrs, ips, searchgrid, 
+                                   searchgrid_elmin, searchgrid_elmax, 
+                                   searchgrid_pmin, searchgrid_pmax, searchgrid_h, searchgrid_n, lh);
+        break;
+      case 3:
+        T_FindElementsOfPoints<3> (*this, points, elnrs, ips, searchgrid, 
+                                   searchgrid_elmin, searchgrid_elmax, 
+                                   searchgrid_pmin, searchgrid_pmax, searchgrid_h, searchgrid_n, lh);
+        break;
+      default:
+        throw Exception ("FindElementsOfPoints: only for 2D and 3D meshes");
+      }
+  }
+
+
+  class GeometryCache
+  {
+  public:
+    /// one integration rule on one element
+    struct Entry
+    {
+      Entry * next;
+      int nip;
+      /// reference coordinates, then rows of points and Jacobians
+      Array<double> data;
+    };
+
+    size_t maxbytes;
+    atomic<size_t> bytes;
+    /// list of entries for every element, volume and boundary
+    Array<atomic<Entry*>> elements[2];
+
+    GeometryCache (const MeshAccess & ma, size_t amaxbytes)
+      : maxbytes(amaxbytes), bytes(0)
+    {
+      for (int bnd = 0; bnd < 2; bnd++)
+        {
+          Array<atomic<Entry*>> hel(ma.GetNE(VorB(bnd)));
+          for (int i = 0; i < hel.Size(); i++)
+            hel[i] = nullptr;
+          elements[bnd].Swap (hel);
+        }
+    }
+
+    ~GeometryCache ()
+    {
+      for (int bnd = 0; bnd < 2; bnd++)
+        for (int i = 0; i < elements[bnd].Size(); i++)
+          for (Entry * entry = elements[bnd][i]; entry; )
+            {
+              Entry * next = entry->next;
+              delete entry;
+              entry = next;
+            }
+    }
+  };
+
+
+  void MeshAccess :: SetGeometryCache (size_t maxbytes)
+  {
+    delete geometrycache;
+    geometrycache = nullptr;
+    if (maxbytes > 0)
+      geometrycache = new GeometryCache (*this, maxbytes);
+  }
+
+  size_t MeshAccess :: GetGeometryCacheBytes () const
+  {
+    return geometrycache ? size_t(geometrycache->bytes) : 0;
+  }
+
+  void MeshAccess :: ClearGeometryCache ()
+  {
+    if (geometrycache)
+      SetGeometryCache (geometrycache->maxbytes);
+  }
+
+  bool MeshAccess :: GetCachedGeometry (bool boundary, int elnr, const IntegrationRule & ir,
+                                        SliceMatrix<> points, SliceMatrix<> jacobians) const
+  {
+    if (!geometrycache) return false;
+    auto & elements = geometrycache->elements[boundary];
+    if (elnr >= elements.Size()) return false;
+
+    int nip = ir.Size();
+    for (GeometryCache::Entry * entry = elements[elnr]; entry; entry = entry->next)
+      {
+        if (entry->nip != nip) continue;
+
+        // rules are compared by their points, not by their address
+        double * hp = &entry->data[0];
+        bool same = true;
+        for (int i = 0; i < nip && same; i++)
+          for (int k = 0; k < 3; k++)
+            if (*hp++ != ir[i](k)) same = false;
+        if (!same) continue;
+
+        for (int j = 0; j < points.Height(); j++, hp += nip)
+          points.Row(j) = FlatVector<> (nip, hp);
+        for (int j = 0; j < jacobians.Height(); j++, hp += nip)
+          jacobians.Row(j) = FlatVector<> (nip, hp);
+        return true;
+      }
+    return false;
+  }
+
+  void MeshAccess :: CacheGeometry (bool boundary, int elnr, const IntegrationRule & ir,
+                                    SliceMatrix<> points, SliceMatrix<> jacobians) const
+  {
+    if (!geometrycache) return;
+    auto & elements = geometrycache->elements[boundary];
+    if (elnr >= elements.Size()) return;
+
+    int nip = ir.Size();
+    int ndata = nip * (3 + points.Height() + jacobians.Height());
+    size_t entrybytes = sizeof(GeometryCache::Entry) + ndata * sizeof(double);
+    if (geometrycache->bytes.fetch_add (entrybytes) + entrybytes > geometrycache->maxbytes)
+      {
+        geometrycache->bytes -= entrybytes;
+        return;
+      }
+
+    auto entry = new GeometryCache::Entry;
+    entry->nip = nip;
+    entry->data.SetSize (ndata);
+    double * hp = &entry->data[0];
+    for (int i = 0; i < nip; i++)
+      for (int k = 0; k < 3; k++)
+        *hp++ = ir[i](k);
+    for (int j = 0; j < points.Height(); j++, hp += nip)
+      FlatVector<> (nip, hp) = points.Row(j);
+    for (int j = 0; j < jacobians.Height(); j++, hp += nip)
+      FlatVector<> (nip, hp) = jacobians.Row(j);
+
+    // insert at the front, another thread may insert as well
+    entry->next = elements[elnr];
+    while (!elements[elnr].compare_exchange_weak (entry->next, entry))
+      ;
+  }
+
+
   int MeshAccess :: GetNPairsPeriodicVertices () const 
   {
     return Ng_GetNPeriodicVertices(0);
@@ -189,6 +189,7 @@ namespace ngcomp
   */
 
   class GridFunction;
+  class GeometryCache;
 
   class NGS_DLL_HEADER MeshAccess : public BaseStatusHandler
   {
@@ -225,6 +226,18 @@ namespace ngcomp
     /// for ALE
     shared_ptr<GridFunction> deformation;  
 
+    /// uniform grid of volume elements for FindElementsOfPoints, built on first use
+    mutable atomic<bool> searchgrid_valid{false};
+    /// elements overlapping every cell
+    mutable Table<int> searchgrid;
+    /// bounding boxes of the elements
+    mutable Array<Vec<3>> searchgrid_elmin, searchgrid_elmax;
+    mutable Vec<3> searchgrid_pmin, searchgrid_pmax, searchgrid_h;
+    mutable int searchgrid_n[3];
+
+    /// points and Jacobians of curved elements, see SetGeometryCache
+    GeometryCache * geometrycache = nullptr;
+
   public:
     /// connects to Netgen - mesh
     MeshAccess (shared_ptr<netgen::Mesh> amesh = NULL);
@@ -482,6 +495,8 @@ namespace ngcomp
     void SetDeformation (shared_ptr<GridFunction> def)
     {
       deformation = def;
+      searchgrid_valid = false;
+      ClearGeometryCache();
     }
 
     shared_ptr<GridFunction> GetDeformation () const
@@ -708,6 +723,42 @@ namespace ngcomp
 				   bool build_searchtree,
 				   int index) const;
 
+    /**
+       Finds the volume elements of many points at once, in parallel.
+       The rows of points are the coordinates, columns beyond the
+       dimension of the mesh are ignored. elnrs[i] is -1 if point i is
+       not in the mesh. Uses a grid of element bounding boxes, which is
+       built on the first call and kept until the mesh changes.
+    */
+    void FindElementsOfPoints (FlatMatrix<double> points,
+                               FlatArray<int> elnrs,
+                               FlatArray<IntegrationPoint> ips,
+                               LocalHeap & lh) const;
+
+    /// (re)builds the search grid of FindElementsOfPoints
+    void BuildSearchGrid (LocalHeap & lh) const;
+
+    /**
+       Keeps the mapped points and Jacobians of curved elements for
+       every integration rule used, up to maxbytes of memory. Repeated
+       assembly on a fixed mesh, as in time-stepping or Newton's method,
+       then skips the element transformation of Netgen. The cache is
+       cleared by SetDeformation and by mesh updates. Elements with
+       deformation are not cached, since the deformation may change
+       without notice. maxbytes = 0 switches the cache off.
+    */
+    void SetGeometryCache (size_t maxbytes);
+    /// memory used by the geometry cache
+    size_t GetGeometryCacheBytes () const;
+    /// removes all entries, keeps the cache switched on
+    void ClearGeometryCache ();
+    /// copies points and Jacobians from the cache, false if not cached
+    bool GetCachedGeometry (bool boundary, int elnr, const IntegrationRule & ir,
+                            SliceMatrix<> points, SliceMatrix<> jacobians) const;
+    /// stores points and Jacobians, if the memory limit allows
+    void CacheGeometry (bool boundary, int elnr, const IntegrationRule & ir,
+                        SliceMatrix<> points, SliceMatrix<> jacobians) const;
+
     /// is element straight or curved ?
     bool IsElementCurved (int elnr) const
     { return bool (Ng_IsElementCurved (elnr+1)); }
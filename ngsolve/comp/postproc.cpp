@@ -504,16 +504,23 @@ namespace ngcomp
     shared_ptr<BilinearFormIntegrator> fluxbli =
       bound ? fesflux.GetBoundaryIntegrator() : fesflux.GetIntegrator();
 
-    Array<int> dnums;
-    Array<int> dnumsflux;
+    ProgressOutput progress (ma, "error estimator element", ne);
 
+    // elements are independent, every thread sums up its own elements
     double sum = 0;
+#pragma omp parallel reduction(+:sum)
+    {
+      LocalHeap & clh = lh, lh = clh.Split();
+      Array<int> dnums;
+      Array<int> dnumsflux;
+
+#pragma omp for schedule(dynamic)
     for (int i = 0; i < ne; i++)
       {
         ElementId ei(VorB(bound),i);
 
 	HeapReset hr(lh);
-	ma->SetThreadPercentage ( 100.0*i / ne );
+	progress.Update();
 
 	int eldom = ma->GetElIndex(ei);
         // bound ? ma->GetSElIndex(i) : ma->GetElIndex(i);
@@ -568,6 +575,9 @@ namespace ngcomp
 	err(i) += elerr;
 	sum += elerr;
       }
+    }
+
+    progress.Done();
     ma->PopStatus ();
   }
   
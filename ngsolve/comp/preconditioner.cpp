@@ -609,6 +609,105 @@ namespace ngcomp
 
 
 
+  // ****************************** AggregationAMGPreconditioner *********************
+
+
+  /**
+     Smoothed aggregation AMG. Needs only the assembled matrix, neither a
+     mesh hierarchy nor edge weights.
+  */
+  class NGS_DLL_HEADER AggregationAMGPreconditioner : public Preconditioner
+  {
+    shared_ptr<BilinearForm> bfa;
+    shared_ptr<BaseAggregationAMG> amg;
+    string inversetype;
+    double theta;
+    int levels, coarsesize, smoothingsteps;
+
+  public:
+    AggregationAMGPreconditioner (const PDE & pde, const Flags & aflags,
+                                  const string aname = "aggamgprecond")
+      : Preconditioner(&pde,aflags,aname)
+    {
+      bfa = pde.GetBilinearForm (flags.GetStringFlag ("bilinearform", NULL));
+      SetFlags ();
+    }
+
+    AggregationAMGPreconditioner (shared_ptr<BilinearForm> abfa, const Flags & aflags,
+                                  const string aname = "aggamgprecond")
+      : Preconditioner(abfa,aflags,aname), bfa(abfa)
+    {
+      SetFlags ();
+    }
+
+    void SetFlags ()
+    {
+      inversetype = flags.GetStringFlag("inverse", GetInverseName (default_inversetype));
+      theta = flags.GetNumFlag ("theta", 0.08);
+      levels = int (flags.GetNumFlag ("levels", 20));
+      coarsesize = int (flags.GetNumFlag ("coarsesize", 500));
+      smoothingsteps = int (flags.GetNumFlag ("smoothingsteps", 1));
+    }
+
+    virtual void Update ()
+    {
+      static Timer t ("AggregationAMGPreconditioner::Update");
+      RegionTimer reg(t);
+
+      double starttime = WallTime();
+
+      const BaseMatrix & mat = bfa->GetMatrix();
+      mat.SetInverseType (inversetype);
+      const BitArray * freedofs = 
+        bfa->GetFESpace()->GetFreeDofs (bfa->UsesEliminateInternal());
+
+      amg = nullptr;
+      amg = CreateAggregationAMG (mat, freedofs, theta, levels, coarsesize, smoothingsteps);
+
+      cout << IM(1) << "AMG setup time = " << WallTime()-starttime << endl;
+      amg -> PrintReport (cout);
+
+      if (test) Test();
+    }
+
+    virtual void CleanUpLevel ()
+    {
+      amg = nullptr;
+    }
+
+    virtual const BaseMatrix & GetMatrix() const
+    {
+      return *amg;
+    }
+
+    virtual const BaseMatrix & GetAMatrix() const
+    {
+      return bfa->GetMatrix(); 
+    }
+
+    virtual const char * ClassName() const
+    {
+      return "Aggregation AMG Preconditioner"; 
+    }
+
+    virtual void PrintReport (ostream & ost)
+    {
+      Preconditioner::PrintReport (ost);
+      if (amg) amg -> PrintReport (ost);
+    }
+
+    virtual void MemoryUsage (Array<MemoryUsageStruct*> & mu) const
+    {
+      if (amg) amg -> MemoryUsage (mu);
+    }
+  };
+
+
+
+
+
+
+
   // ****************************** LocalPreconditioner *******************************
 
 
@@ -1215,6 +1314,7 @@ ComplexPreconditioner :: ComplexPreconditioner (PDE * apde, const Flags & aflags
 
   RegisterPreconditioner<MGPreconditioner> registerMG("multigrid");
   RegisterPreconditioner<DirectPreconditioner> registerDirect("direct");
+  RegisterPreconditioner<AggregationAMGPreconditioner> registerAggregationAMG("aggamg");
 
 }
 
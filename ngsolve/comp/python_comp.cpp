@@ -169,6 +169,14 @@ void NGS_DLL_HEADER ExportNgcomp()
           bp::return_value_policy<bp::reference_existing_object>())
 
     .def("SetDeformation", &MeshAccess::SetDeformation)
+
+    .def("SetGeometryCache", FunctionPointer
+         ([](MeshAccess & ma, double maxmb)
+          {
+            ma.SetGeometryCache (size_t (1e6 * maxmb));
+          }),
+         (bp::arg("self"), bp::arg("maxmb")),
+         "keep points and Jacobians of curved elements, up to maxmb megabytes, 0 switches off")
     
     .def("GetMaterials", FunctionPointer
 	 ([](const MeshAccess & ma)
@@ -307,6 +315,53 @@ void NGS_DLL_HEADER ExportNgcomp()
                    }),
                   "list of coefficient vectors for multi-dim gridfunction")
     
+    // boost.python tries the overloads in reverse order, so the scalar
+    // version below is tried first and gf(0.5) stays a point evaluation
+    .def("__call__", FunctionPointer
+         ([](GF & self, bp::object pypoints)
+          {
+            // an N x dim matrix, or a list of coordinate tuples
+            Matrix<> points;
+            bp::extract<FlatMatrix<double>> mpoints(pypoints);
+            if (mpoints.check())
+              {
+                FlatMatrix<double> fm = mpoints();
+                points.SetSize (fm.Height(), fm.Width());
+                points = fm;
+              }
+            else
+              {
+                int np = bp::len(pypoints);
+                points.SetSize (np, 3);
+                points = 0.0;
+                for (int i = 0; i < np; i++)
+                  {
+                    bp::object pi = pypoints[i];
+                    for (int j = 0; j < min2 (3, int(bp::len(pi))); j++)
+                      points(i,j) = bp::extract<double> (pi[j])();
+                  }
+              }
+
+            auto space = self.GetFESpace();
+            int dim = space->GetEvaluator()->Dim();
+            LocalHeap lh(1000000*omp_get_max_threads(), "ngcomp::GridFunction::Eval");
+
+            if (space->IsComplex())
+              {
+                Matrix<Complex> values(points.Height(), dim);
+                self.Evaluate (points, values, lh);
+                return bp::object(values);
+              }
+            else
+              {
+                Matrix<> values(points.Height(), dim);
+                self.Evaluate (points, values, lh);
+                return bp::object(values);
+              }
+          }),
+         (bp::arg("self"), bp::arg("points")),
+         "evaluate in many points at once, returns a matrix with one row per point")
+
     .def("__call__", FunctionPointer
          ([](GF & self, double x, double y, double z)
           {
@@ -68,10 +68,53 @@ namespace ngfem
                          LocalHeap & lh) const
     {
       static int timer = NgProfiler::CreateTimer ("DGInnerFacet_LaplaceIntegrator");
+      NgProfiler::RegionTimer reg (timer);
 
-      if (LocalFacetNr2==-1) throw Exception("DGFacetLaplaceIntegrator: LocalFacetNr2==1");
+      elmat = 0.0;
+      FlatMatrixFixHeight<2> dbmat(elmat.Width(), lh);
+      T_FacetLoop (volumefel1, LocalFacetNr1, eltrans1, ElVertices1,
+                   volumefel2, LocalFacetNr2, eltrans2, ElVertices2, lh,
+                   [&] (FlatMatrixFixHeight<2> bmat, const Mat<2> & dmat)
+                   {
+                     dbmat = dmat * bmat;
+                     elmat += Trans (bmat) * dbmat;
+                   });
+      if (LocalFacetNr2==-1) elmat=0.0;
+    }
 
+    virtual void ApplyFacetMatrix (const FiniteElement & volumefel1, int LocalFacetNr1,
+                                   const ElementTransformation & eltrans1, FlatArray<int> & ElVertices1,
+                                   const FiniteElement & volumefel2, int LocalFacetNr2,
+                                   const ElementTransformation & eltrans2, FlatArray<int> & ElVertices2,
+                                   FlatVector<double> elx, FlatVector<double> ely,
+                                   LocalHeap & lh) const
+    {
+      static int timer = NgProfiler::CreateTimer ("DGInnerFacet_LaplaceIntegrator apply");
       NgProfiler::RegionTimer reg (timer);
+
+      HeapReset hr(lh);
+      ely = 0.0;
+      T_FacetLoop (volumefel1, LocalFacetNr1, eltrans1, ElVertices1,
+                   volumefel2, LocalFacetNr2, eltrans2, ElVertices2, lh,
+                   [&] (FlatMatrixFixHeight<2> bmat, const Mat<2> & dmat)
+                   {
+                     Vec<2> hv = bmat * elx;
+                     Vec<2> dhv = dmat * hv;
+                     ely += Trans (bmat) * dhv;
+                   });
+    }
+
+  private:
+    /// calls func (bmat, dmat) for every integration point on the facet
+    template <typename FUNC>
+    void T_FacetLoop (const FiniteElement & volumefel1, int LocalFacetNr1,
+                      const ElementTransformation & eltrans1, FlatArray<int> & ElVertices1,
+                      const FiniteElement & volumefel2, int LocalFacetNr2,
+                      const ElementTransformation & eltrans2, FlatArray<int> & ElVertices2,
+                      LocalHeap & lh, FUNC func) const
+    {
+      if (LocalFacetNr2==-1) throw Exception("DGFacetLaplaceIntegrator: LocalFacetNr2==1");
+
       const ScalarFiniteElement<D> * fel1_l2 = 
         dynamic_cast<const ScalarFiniteElement<D>*> (&volumefel1);
       ELEMENT_TYPE eltype1 = volumefel1.ElementType();
@@ -85,20 +128,14 @@ namespace ngfem
       int nd2 = fel2_l2->GetNDof();
       int maxorder = max2(fel1_l2->Order(),fel2_l2->Order());
       
-      elmat = 0.0;
-
       FlatVector<> mat1_shape(nd1, lh);
       FlatVector<> mat1_dudn(nd1, lh);
       FlatVector<> mat2_shape(nd2, lh);
       FlatVector<> mat2_dudn(nd2, lh);
       
       FlatMatrixFixHeight<2> bmat(nd1+nd2, lh);
-      FlatMatrixFixHeight<2> dbmat(nd1+nd2, lh);
       Mat<2> dmat;
 
-      FlatMatrixFixWidth<D> dshape(nd1, lh);
-      FlatMatrixFixWidth<D> fac_dshape(nd1, lh);
-      
       Facet2ElementTrafo transform1(eltype1,ElVertices1); 
       Facet2ElementTrafo transform2(eltype2,ElVertices2); 
 
@@ -121,6 +158,7 @@ namespace ngfem
       bmat = 0.0;
       for (int l = 0; l < ir_facet.GetNIP(); l++)
 	{
+	  HeapReset hr(lh);
 	  IntegrationPoint ip1 = transform1(LocalFacetNr1, ir_facet[l]);
 	  
 	  MappedIntegrationPoint<D,D> sip1 (ip1, eltrans1);
@@ -182,10 +220,8 @@ namespace ngfem
 	      break;	      
 	  }
 	  dmat *= lam * len1 * ir_facet[l].Weight();
-	  dbmat = dmat * bmat;
-	  elmat += Trans (bmat) * dbmat;
+	  func (bmat, dmat);
 	}
-	if (LocalFacetNr2==-1) elmat=0.0;
       }
   };
 
@@ -549,6 +585,45 @@ namespace ngfem
     {
       static int timer = NgProfiler::CreateTimer ("DGBoundaryFacet_LaplaceIntegrator boundary");
       NgProfiler::RegionTimer reg (timer);
+
+      elmat = 0.0;
+      FlatMatrixFixHeight<2> dbmat(elmat.Width(), lh);
+      T_FacetLoop (volumefel, LocalFacetNr, eltrans, ElVertices, seltrans, lh,
+                   [&] (FlatMatrixFixHeight<2> bmat, const Mat<2> & dmat)
+                   {
+                     dbmat = dmat * bmat;
+                     elmat += Trans (bmat) * dbmat;
+                   });
+    }
+
+    virtual void ApplyFacetMatrix (const FiniteElement & volumefel, int LocalFacetNr,
+                                   const ElementTransformation & eltrans, FlatArray<int> & ElVertices,
+                                   const ElementTransformation & seltrans,
+                                   FlatVector<double> elx, FlatVector<double> ely,
+                                   LocalHeap & lh) const
+    {
+      static int timer = NgProfiler::CreateTimer ("DGBoundaryFacet_LaplaceIntegrator boundary apply");
+      NgProfiler::RegionTimer reg (timer);
+
+      HeapReset hr(lh);
+      ely = 0.0;
+      T_FacetLoop (volumefel, LocalFacetNr, eltrans, ElVertices, seltrans, lh,
+                   [&] (FlatMatrixFixHeight<2> bmat, const Mat<2> & dmat)
+                   {
+                     Vec<2> hv = bmat * elx;
+                     Vec<2> dhv = dmat * hv;
+                     ely += Trans (bmat) * dhv;
+                   });
+    }
+
+  private:
+    /// calls func (bmat, dmat) for every integration point on the facet
+    template <typename FUNC>
+    void T_FacetLoop (const FiniteElement & volumefel, int LocalFacetNr,
+                      const ElementTransformation & eltrans, FlatArray<int> & ElVertices,
+                      const ElementTransformation & seltrans,
+                      LocalHeap & lh, FUNC func) const
+    {
       const ScalarFiniteElement<D> * fel1_l2 = 
         dynamic_cast<const ScalarFiniteElement<D>*> (&volumefel);
       ELEMENT_TYPE eltype1 = volumefel.ElementType();
@@ -560,18 +635,12 @@ namespace ngfem
 
       int maxorder = fel1_l2->Order();
 
-      
-      elmat = 0.0;
-
       FlatVector<> mat1_shape(nd1, lh);
       FlatVector<> mat1_dudn(nd1, lh);
       
       FlatMatrixFixHeight<2> bmat(nd1+nd2, lh);
-      FlatMatrixFixHeight<2> dbmat(nd1+nd2, lh);
       Mat<2> dmat;
 
-      FlatMatrixFixWidth<D> dshape(nd1, lh);
-      FlatMatrixFixWidth<D> fac_dshape(nd1, lh);
       Facet2ElementTrafo transform1(eltype1,ElVertices); 
       const NORMAL * normals1 = ElementTopology::GetNormals(eltype1);
       
@@ -589,6 +658,7 @@ namespace ngfem
       bmat = 0.0;
       for (int l = 0; l < ir_facet.GetNIP(); l++)
 	{
+	  HeapReset hr(lh);
 	  IntegrationPoint ip1 = transform1(LocalFacetNr, ir_facet[l]);
 	  
 	  MappedIntegrationPoint<D,D> sip1 (ip1, eltrans);
@@ -632,8 +702,7 @@ namespace ngfem
 	      break;	      
 	  }
 	  dmat *= lam * len1 * ir_facet[l].Weight();
-	  dbmat = dmat * bmat;
-	  elmat += Trans (bmat) * dbmat;
+	  func (bmat, dmat);
 	}
       }
   };
@@ -100,6 +100,36 @@ namespace ngfem
 	}
     }
 
+    static void ApplyIR (const FiniteElement & fel, const MappedIntegrationRule<D,D> & mir,
+			 const FlatVector<double> x, FlatMatrixFixWidth<D,double> y,
+			 LocalHeap & lh)
+    {
+      FlatMatrixFixWidth<D> grad(mir.Size(), &y(0));
+      Cast(fel).EvaluateGrad (mir.IR(), x, grad);
+      if (!mir.HasSoA())
+        {
+          for (int i = 0; i < mir.Size(); i++)
+            {
+              Vec<D> hv = grad.Row(i);
+              grad.Row(i) = Trans (mir[i].GetJacobianInverse()) * hv;
+            }
+          return;
+        }
+
+      SliceMatrix<> ijac = mir.GetJacobianInverseSoA();
+      for (int i = 0; i < mir.Size(); i++)
+	{
+	  Vec<D> hv = grad.Row(i);
+          for (int k = 0; k < D; k++)
+            {
+              double sum = 0;
+              for (int j = 0; j < D; j++)
+                sum += ijac(j*D+k, i) * hv(j);
+              grad(i,k) = sum;
+            }
+	}
+    }
+
 
     ///
     template <typename MIP, class TVX, class TVY>
@@ -1108,10 +1138,54 @@ namespace ngfem
     : public T_BDBIntegrator<DiffOpGradient<D>, DiagDMat<D>, FEL>
   {
     typedef T_BDBIntegrator<DiffOpGradient<D>, DiagDMat<D>, FEL> BASE;
-    
+    /// apply by sum factorization, where possible
+    bool sumfactorization = false;
   public:
     using BASE::T_BDBIntegrator;
     virtual string Name () const { return "Laplace"; }
+
+    virtual void SetFlags (const Flags & flags)
+    { sumfactorization = flags.GetDefineFlag ("sumfactorization"); }
+
+    using BASE::ApplyElementMatrix;
+    virtual void 
+    ApplyElementMatrix (const FiniteElement & fel, 
+                        const ElementTransformation & eltrans, 
+                        const FlatVector<double> elx, 
+                        FlatVector<double> ely,
+                        void * precomputed,
+                        LocalHeap & lh) const
+    {
+      if (D != 3 || !sumfactorization || !L2HexSumFactorization::Applicable (fel))
+        {
+          BASE::ApplyElementMatrix (fel, eltrans, elx, ely, precomputed, lh);
+          return;
+        }
+
+      HeapReset hr(lh);
+      int intorder = this->GetIntegrationOrder (fel, eltrans.HigherIntegrationOrderSet());
+      IntegrationRule ir(ET_HEX, intorder);
+      MappedIntegrationRule<D,D> & mir = 
+        static_cast<MappedIntegrationRule<D,D>&> (eltrans(ir, lh));
+
+      FlatMatrixFixWidth<D> hv(ir.GetNIP(), lh);
+      FlatMatrixFixWidth<3> hv3(ir.GetNIP(), &hv(0,0));
+      L2HexSumFactorization::EvaluateGrad (fel, intorder, elx, hv3, lh);
+      for (int i = 0; i < mir.Size(); i++)
+        {
+          Vec<D> gradref = hv.Row(i);
+          hv.Row(i) = Trans (mir[i].GetJacobianInverse()) * gradref;
+        }
+
+      this->dmatop.ApplyIR (fel, mir, hv, lh);
+
+      for (int i = 0; i < mir.Size(); i++)
+        {
+          Vec<D> flux = mir[i].GetWeight() * hv.Row(i);
+          hv.Row(i) = mir[i].GetJacobianInverse() * flux;
+        }
+      L2HexSumFactorization::EvaluateGradTrans (fel, intorder, hv3, ely, lh);
+    }
   };
 
 
@@ -1162,9 +1236,43 @@ namespace ngfem
     : public T_BDBIntegrator<DiffOpId<D>, DiagDMat<1>, FEL >
   {
     typedef T_BDBIntegrator<DiffOpId<D>, DiagDMat<1>, FEL> BASE;
+    /// apply by sum factorization, where possible
+    bool sumfactorization = false;
   public:
     using BASE::T_BDBIntegrator;
     virtual string Name () const { return "Mass"; }
+
+    virtual void SetFlags (const Flags & flags)
+    { sumfactorization = flags.GetDefineFlag ("sumfactorization"); }
+
+    using BASE::ApplyElementMatrix;
+    virtual void 
+    ApplyElementMatrix (const FiniteElement & fel, 
+                        const ElementTransformation & eltrans, 
+                        const FlatVector<double> elx, 
+                        FlatVector<double> ely,
+                        void * precomputed,
+                        LocalHeap & lh) const
+    {
+      if (D != 3 || !sumfactorization || !L2HexSumFactorization::Applicable (fel))
+        {
+          BASE::ApplyElementMatrix (fel, eltrans, elx, ely, precomputed, lh);
+          return;
+        }
+
+      HeapReset hr(lh);
+      int intorder = this->GetIntegrationOrder (fel, eltrans.HigherIntegrationOrderSet());
+      IntegrationRule ir(ET_HEX, intorder);
+      BaseMappedIntegrationRule & mir = eltrans(ir, lh);
+
+      FlatMatrixFixWidth<1> hv(ir.GetNIP(), lh);
+      FlatVector<> vals(ir.GetNIP(), &hv(0,0));
+      L2HexSumFactorization::Evaluate (fel, intorder, elx, vals, lh);
+      this->dmatop.ApplyIR (fel, mir, hv, lh);
+      for (int i = 0; i < mir.Size(); i++)
+        vals(i) *= mir[i].GetWeight();
+      L2HexSumFactorization::EvaluateTrans (fel, intorder, vals, ely, lh);
+    }
   };
 
 
@@ -473,8 +473,15 @@ public:
       FlatMatrixFixWidth<DMATOP::DIM_DMAT, TSCAL> hv1(ir.GetNIP(), lh);
       diffop->Apply (fel, mir, elx, hv1, lh);
       dmatop.ApplyIR (fel, mir, hv1, lh);
-      for (int i = 0; i < mir.Size(); i++)
-        hv1.Row(i) *= mir[i].GetWeight();
+      if (mir.HasSoA())
+        {
+          FlatVector<> weights = mir.GetWeightSoA();
+          for (int i = 0; i < mir.Size(); i++)
+            hv1.Row(i) *= weights(i);
+        }
+      else
+        for (int i = 0; i < mir.Size(); i++)
+          hv1.Row(i) *= mir[i].GetWeight();
       diffop->ApplyTrans (fel, mir, hv1, ely, lh);    
     }
     
@@ -846,6 +853,7 @@ public:
 
         FlatArray<TDMAT> dmats(ir.GetNIP(), lh);
 	dmatop.GenerateMatrixIR (fel, mir, dmats, lh);
+        FlatVector<> weights = mir.GetWeightSoA();
 
         int i = 0;
         for (int i1 = 0; i1 < ir.GetNIP() / BLOCK; i1++)
@@ -855,7 +863,7 @@ public:
             for (int i2 = 0; i2 < BLOCK; i2++)
               {
 		IntRange rows (i2*DIM_DMAT, (i2+1)*DIM_DMAT);
-		TDMAT dmat = mir[i+i2].GetWeight() * dmats[i+i2];
+		TDMAT dmat = weights(i+i2) * dmats[i+i2];
 		bdbmat.Rows(rows) = dmat * bbmat.Rows(rows);
               }
 
@@ -874,7 +882,7 @@ public:
             for (int i2 = 0; i2 < rest; i2++)
               {
 		IntRange rows (i2*DIM_DMAT, (i2+1)*DIM_DMAT);
-		TDMAT dmat = mir[i+i2].GetWeight() * dmats[i+i2];
+		TDMAT dmat = weights(i+i2) * dmats[i+i2];
 		bdbmat.Rows(rows) = dmat * bbmat.Rows(rows);
               }
 
@@ -1447,8 +1455,9 @@ public:
 
 	FlatMatrixFixWidth<DIM_DMAT, TSCAL> dvecs(ir.GetNIP(), lh);
 	dvecop.GenerateVectorIR (fel, mir, dvecs, lh);
+        FlatVector<> weights = mir.GetWeightSoA();
         for (int i = 0; i < ir.GetNIP(); i++)
-          dvecs.Row(i) *= mir[i].GetWeight();
+          dvecs.Row(i) *= weights(i);
 
         // DIFFOP::ApplyTransIR (fel, mir, dvecs, elvec, lh);
         diffop->ApplyTrans (fel, mir, dvecs, elvec, lh);
@@ -299,8 +299,15 @@ Evaluate (const BaseMappedIntegrationRule & ir,
     {
       ArrayMem<double,2000> mem(ir.Size()*numarg);
       FlatMatrix<> args(ir.Size(), numarg, &mem[0]);
-      for (int i = 0; i < ir.Size(); i++)
-        args.Row(i).Range(0,ir[i].Dim()) = ir[i].GetPoint();
+      if (ir.HasSoA())
+        {
+          SliceMatrix<> points = ir.GetPointsSoA();
+          for (int j = 0; j < points.Height(); j++)
+            args.Col(j) = points.Row(j);
+        }
+      else
+        for (int i = 0; i < ir.Size(); i++)
+          args.Row(i).Range(0,ir[i].Dim()) = ir[i].GetPoint();
       /*
 	args.Row(i).Range(0,DIM) = 
 	  static_cast<const DimMappedIntegrationPoint<DIM> & > (ir[i]).GetPoint();
@@ -313,8 +320,9 @@ Evaluate (const BaseMappedIntegrationRule & ir,
 	  args.Cols(an,an+dim) = hmat;
 	  an += dim;
 	}
-      for (int i = 0; i < ir.Size(); i++)
-	fun[elind]->Eval (&args(i,0), &values(i,0), values.Width());
+      if (ir.Size())
+        fun[elind]->Eval (ir.Size(), &args(0,0), numarg, 
+                          &values(0,0), values.Width(), values.Width());
     }
   else
     {
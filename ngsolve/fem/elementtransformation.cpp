@@ -115,23 +115,20 @@ namespace ngfem
     MappedIntegrationRule<DIMS,DIMR> & mir = 
       static_cast<MappedIntegrationRule<DIMS,DIMR> &>(bmir);
     
-    Vector<> shapes(ir.Size());
+    SliceMatrix<> points = mir.GetPointsSoA();
+    SliceMatrix<> jac = mir.GetJacobianSoA();
     MatrixFixWidth<DIMS> grad(ir.Size());
 
     for (int j = 0; j < DIMR; j++)
       {
-	fel->Evaluate (ir, pointmat.Row(j), shapes);
+	fel->Evaluate (ir, pointmat.Row(j), points.Row(j));
 	fel->EvaluateGrad (ir, pointmat.Row(j), grad);
 	
-	for (int i = 0; i < ir.Size(); i++)
-	  {
-	    mir[i].Point()(j) = shapes(i);
-	    mir[i].Jacobian().Row(j) = grad.Row(i);
-	  }
+	for (int k = 0; k < DIMS; k++)
+	  jac.Row(j*DIMS+k) = grad.Col(k);
       }
 
-    for (int i = 0; i < ir.Size(); i++)
-      mir[i].Compute();
+    mir.ComputeSoA();
   }
   
   
@@ -638,6 +638,62 @@ namespace ngfem
     }
 
 
+    /// ely = facet-matrix * elx, default computes the facet matrix
+    virtual void
+    ApplyFacetMatrix (const FiniteElement & volumefel1, int LocalFacetNr1,
+                      const ElementTransformation & eltrans1, FlatArray<int> & ElVertices1,
+                      const FiniteElement & volumefel2, int LocalFacetNr2,
+                      const ElementTransformation & eltrans2, FlatArray<int> & ElVertices2,
+                      FlatVector<double> elx, FlatVector<double> ely,
+                      LocalHeap & lh) const
+    {
+      HeapReset hr(lh);
+      FlatMatrix<double> elmat(ely.Size(), elx.Size(), lh);
+      CalcFacetMatrix (volumefel1, LocalFacetNr1, eltrans1, ElVertices1,
+                       volumefel2, LocalFacetNr2, eltrans2, ElVertices2, elmat, lh);
+      ely = elmat * elx;
+    }
+    virtual void
+    ApplyFacetMatrix (const FiniteElement & volumefel1, int LocalFacetNr1,
+                      const ElementTransformation & eltrans1, FlatArray<int> & ElVertices1,
+                      const FiniteElement & volumefel2, int LocalFacetNr2,
+                      const ElementTransformation & eltrans2, FlatArray<int> & ElVertices2,
+                      FlatVector<Complex> elx, FlatVector<Complex> ely,
+                      LocalHeap & lh) const
+    {
+      HeapReset hr(lh);
+      FlatMatrix<Complex> elmat(ely.Size(), elx.Size(), lh);
+      CalcFacetMatrix (volumefel1, LocalFacetNr1, eltrans1, ElVertices1,
+                       volumefel2, LocalFacetNr2, eltrans2, ElVertices2, elmat, lh);
+      ely = elmat * elx;
+    }
+
+    /// ely = facet-matrix * elx for boundary facets
+    virtual void
+    ApplyFacetMatrix (const FiniteElement & volumefel, int LocalFacetNr,
+                      const ElementTransformation & eltrans, FlatArray<int> & ElVertices,
+                      const ElementTransformation & seltrans,
+                      FlatVector<double> elx, FlatVector<double> ely,
+                      LocalHeap & lh) const
+    {
+      HeapReset hr(lh);
+      FlatMatrix<double> elmat(ely.Size(), elx.Size(), lh);
+      CalcFacetMatrix (volumefel, LocalFacetNr, eltrans, ElVertices, seltrans, elmat, lh);
+      ely = elmat * elx;
+    }
+    virtual void
+    ApplyFacetMatrix (const FiniteElement & volumefel, int LocalFacetNr,
+                      const ElementTransformation & eltrans, FlatArray<int> & ElVertices,
+                      const ElementTransformation & seltrans,
+                      FlatVector<Complex> elx, FlatVector<Complex> ely,
+                      LocalHeap & lh) const
+    {
+      HeapReset hr(lh);
+      FlatMatrix<Complex> elmat(ely.Size(), elx.Size(), lh);
+      CalcFacetMatrix (volumefel, LocalFacetNr, eltrans, ElVertices, seltrans, elmat, lh);
+      ely = elmat * elx;
+    }
+
   };
 
 
@@ -195,9 +195,185 @@ namespace ngfem
     for (int i = 0; i < ir.GetNIP(); i++)
       new (&mips[i]) MappedIntegrationPoint<DIM_ELEMENT, DIM_SPACE> (ir[i], eltrans, -1);
 
+    soadist = ir.GetNIP();
+    soadim = DIMR;
+    soa = lh.Alloc<double> (SOA_ROWS*soadist);
+
     eltrans.CalcMultiPointJacobian (ir, *this);
   }
 
+
+  template <int DIM_ELEMENT, int DIM_SPACE>
+  void MappedIntegrationRule<DIM_ELEMENT,DIM_SPACE> :: ComputeSoA ()
+  {
+    int n = Size();
+    int dist = soadist;
+    double * points = soa+SOA_POINTS*dist;
+    double * jac = soa+SOA_JAC*dist;
+    double * ijac = soa+SOA_IJAC*dist;
+    double * det = soa+SOA_DET*dist;
+    double * weight = soa+SOA_WEIGHT*dist;
+    double * nv = soa+SOA_NV*dist;
+
+    if (DIMS == DIMR && DIMS >= 1)
+      for (int i = 0; i < DIMR; i++)
+        for (int p = 0; p < n; p++)
+          nv[i*dist+p] = 0;
+
+    if (DIMS == 1 && DIMR == 1)
+      {
+#pragma omp simd
+        for (int p = 0; p < n; p++)
+          {
+            det[p] = jac[p];
+            ijac[p] = 1.0 / jac[p];
+          }
+      }
+
+    else if (DIMS == 2 && DIMR == 2)
+      {
+        double * a = jac, * b = jac+dist, * c = jac+2*dist, * d = jac+3*dist;
+#pragma omp simd
+        for (int p = 0; p < n; p++)
+          {
+            double hdet = a[p]*d[p] - b[p]*c[p];
+            double idet = 1.0 / hdet;
+            det[p] = hdet;
+            ijac[p] = idet * d[p];
+            ijac[dist+p] = -idet * b[p];
+            ijac[2*dist+p] = -idet * c[p];
+            ijac[3*dist+p] = idet * a[p];
+          }
+      }
+
+    else if (DIMS == 3 && DIMR == 3)
+      {
+        double * j00 = jac, * j01 = jac+dist, * j02 = jac+2*dist;
+        double * j10 = jac+3*dist, * j11 = jac+4*dist, * j12 = jac+5*dist;
+        double * j20 = jac+6*dist, * j21 = jac+7*dist, * j22 = jac+8*dist;
+#pragma omp simd
+        for (int p = 0; p < n; p++)
+          {
+            double c00 = j11[p]*j22[p] - j12[p]*j21[p];
+            double c01 = j12[p]*j20[p] - j10[p]*j22[p];
+            double c02 = j10[p]*j21[p] - j11[p]*j20[p];
+            double hdet = j00[p]*c00 + j01[p]*c01 + j02[p]*c02;
+            double idet = 1.0 / hdet;
+            det[p] = hdet;
+            ijac[p]        = idet * c00;
+            ijac[dist+p]   = idet * (j02[p]*j21[p] - j01[p]*j22[p]);
+            ijac[2*dist+p] = idet * (j01[p]*j12[p] - j02[p]*j11[p]);
+            ijac[3*dist+p] = idet * c01;
+            ijac[4*dist+p] = idet * (j00[p]*j22[p] - j02[p]*j20[p]);
+            ijac[5*dist+p] = idet * (j02[p]*j10[p] - j00[p]*j12[p]);
+            ijac[6*dist+p] = idet * c02;
+            ijac[7*dist+p] = idet * (j01[p]*j20[p] - j00[p]*j21[p]);
+            ijac[8*dist+p] = idet * (j00[p]*j11[p] - j01[p]*j10[p]);
+          }
+      }
+
+    else if (DIMS == 1 && DIMR == 2)
+      {
+        double * a = jac, * b = jac+dist;
+#pragma omp simd
+        for (int p = 0; p < n; p++)
+          {
+            double hdet = sqrt (a[p]*a[p] + b[p]*b[p]);
+            double idet = 1.0 / hdet;
+            det[p] = hdet;
+            nv[p] = -idet * b[p];
+            nv[dist+p] = idet * a[p];
+            ijac[p] = idet*idet * a[p];
+            ijac[dist+p] = idet*idet * b[p];
+          }
+      }
+
+    else if (DIMS == 2 && DIMR == 3)
+      {
+        // columns t0, t1 of the Jacobian, pseudo-inverse (J^T J)^-1 J^T
+        double * t00 = jac, * t01 = jac+2*dist, * t02 = jac+4*dist;
+        double * t10 = jac+dist, * t11 = jac+3*dist, * t12 = jac+5*dist;
+#pragma omp simd
+        for (int p = 0; p < n; p++)
+          {
+            double n0 = t01[p]*t12[p] - t02[p]*t11[p];
+            double n1 = t02[p]*t10[p] - t00[p]*t12[p];
+            double n2 = t00[p]*t11[p] - t01[p]*t10[p];
+            double hdet = sqrt (n0*n0 + n1*n1 + n2*n2);
+            double idet = 1.0 / hdet;
+            det[p] = hdet;
+            nv[p] = idet * n0;
+            nv[dist+p] = idet * n1;
+            nv[2*dist+p] = idet * n2;
+
+            double a00 = t00[p]*t00[p] + t01[p]*t01[p] + t02[p]*t02[p];
+            double a01 = t00[p]*t10[p] + t01[p]*t11[p] + t02[p]*t12[p];
+            double a11 = t10[p]*t10[p] + t11[p]*t11[p] + t12[p]*t12[p];
+            double ia = 1.0 / (a00*a11 - a01*a01);
+            double i00 = ia * a11, i01 = -ia * a01, i11 = ia * a00;
+            ijac[p]        = i00 * t00[p] + i01 * t10[p];
+            ijac[dist+p]   = i00 * t01[p] + i01 * t11[p];
+            ijac[2*dist+p] = i00 * t02[p] + i01 * t12[p];
+            ijac[3*dist+p] = i01 * t00[p] + i11 * t10[p];
+            ijac[4*dist+p] = i01 * t01[p] + i11 * t11[p];
+            ijac[5*dist+p] = i01 * t02[p] + i11 * t12[p];
+          }
+      }
+
+    else
+      {
+        // point elements: no vectorization
+        for (int p = 0; p < n; p++)
+          {
+            MappedIntegrationPoint<DIMS,DIMR> & mip = mips[p];
+            for (int i = 0; i < DIMR; i++)
+              mip.Point()(i) = points[i*dist+p];
+            mip.Compute();
+            det[p] = mip.GetJacobiDet();
+            for (int i = 0; i < DIMR; i++)
+              nv[i*dist+p] = mip.GetNV()(i);
+            weight[p] = mip.GetWeight();
+          }
+        return;
+      }
+
+    for (int p = 0; p < n; p++)
+      weight[p] = fabs (det[p]) * ir[p].Weight();
+
+    for (int p = 0; p < n; p++)
+      {
+        MappedIntegrationPoint<DIMS,DIMR> & mip = mips[p];
+        for (int i = 0; i < DIMR; i++)
+          mip.Point()(i) = points[i*dist+p];
+        for (int i = 0; i < DIMR; i++)
+          for (int j = 0; j < DIMS; j++)
+            mip.Jacobian()(i,j) = jac[(i*DIMS+j)*dist+p];
+        mip.SetJacobiDet (det[p]);
+        Vec<DIMR> hnv;
+        for (int i = 0; i < DIMR; i++)
+          hnv(i) = nv[i*dist+p];
+        mip.SetNV (hnv);
+        mip.SetTV (0.0);
+      }
+  }
+
+
+  template <int DIM_ELEMENT, int DIM_SPACE>
+  void MappedIntegrationRule<DIM_ELEMENT,DIM_SPACE> :: ComputeSoAFromPoints ()
+  {
+    int n = Size();
+    for (int p = 0; p < n; p++)
+      {
+        const MappedIntegrationPoint<DIMS,DIMR> & mip = mips[p];
+        for (int i = 0; i < DIMR; i++)
+          soa[(SOA_POINTS+i)*soadist+p] = mip.GetPoint()(i);
+        for (int i = 0; i < DIMR; i++)
+          for (int j = 0; j < DIMS; j++)
+            soa[(SOA_JAC+i*DIMS+j)*soadist+p] = mip.GetJacobian()(i,j);
+      }
+    ComputeSoA();
+  }
+
   template class MappedIntegrationRule<0,0>;
   template class MappedIntegrationRule<0,1>;
   template class MappedIntegrationRule<1,1>;
@@ -313,6 +313,8 @@ namespace ngfem
     INLINE void SetNV ( const Vec<DIMR,SCAL> & vec) { normalvec = vec; }
     ///
     INLINE void SetTV ( const Vec<DIMR,SCAL> & vec) { tangentialvec = vec; }
+    /// sets the determinant computed outside, see MappedIntegrationRule::ComputeSoA
+    INLINE void SetJacobiDet (SCAL adet) { det = adet; this->measure = fabs (det); }
     ///
     INLINE const Vec<DIMR,SCAL> GetTV () const { return tangentialvec; }
     ///
@@ -873,11 +875,17 @@ namespace ngfem
     const ElementTransformation & eltrans;
     char * baseip;
     int incr;
+    /// geometry in SoA layout, one row per quantity, nullptr if not available
+    double * soa;
+    /// row distance of soa
+    int soadist;
+    /// number of point coordinates in soa
+    int soadim;
 
   public:
     INLINE BaseMappedIntegrationRule (const IntegrationRule & air,
                                       const ElementTransformation & aeltrans)
-      : ir(air.Size(),&air[0]), eltrans(aeltrans) { ; }
+      : ir(air.Size(),&air[0]), eltrans(aeltrans), soa(nullptr), soadist(0), soadim(0) { ; }
     INLINE ~BaseMappedIntegrationRule ()
     {
       ir.NothingToDelete();
@@ -888,12 +896,33 @@ namespace ngfem
 
     INLINE const BaseMappedIntegrationPoint & operator[] (int i) const
     { return *static_cast<const BaseMappedIntegrationPoint*> ((void*)(baseip+i*incr)); }
+
+    /// are the SoA arrays available ?
+    INLINE bool HasSoA () const { return soa != nullptr; }
+    /// integration weights times |det|
+    INLINE FlatVector<> GetWeightSoA () const
+    { return FlatVector<> (soa ? Size() : 0, soa); }
+    /// mapped points, one row per coordinate, one column per point
+    INLINE SliceMatrix<> GetPointsSoA () const 
+    { return SliceMatrix<> (soadim, Size(), soadist, soa+soadist); }
   };
 
+  /**
+     The mapped points are stored as array of MappedIntegrationPoint,
+     and, if constructed by the element transformation, also in SoA
+     layout: Rows of length soadist for the weight (times |det|), the
+     point coordinates, the entries of the Jacobi matrix (row-wise), of
+     its (pseudo)inverse, the determinant and the normal vector.
+     The geometry kernels work on the SoA rows, vectorized over the
+     points, and fill the MappedIntegrationPoints afterwards.
+   */
   template <int DIM_ELEMENT, int DIM_SPACE>
   class NGS_DLL_HEADER MappedIntegrationRule : public BaseMappedIntegrationRule
   {
     FlatArray< MappedIntegrationPoint<DIM_ELEMENT, DIM_SPACE> > mips;
+    enum { DIMS = DIM_ELEMENT, DIMR = DIM_SPACE };
+    enum { SOA_WEIGHT = 0, SOA_POINTS = 1, SOA_JAC = SOA_POINTS+DIMR, SOA_IJAC = SOA_JAC+DIMR*DIMS,
+           SOA_DET = SOA_IJAC+DIMS*DIMR, SOA_NV = SOA_DET+1, SOA_ROWS = SOA_NV+DIMR };
   public:
     MappedIntegrationRule (const IntegrationRule & ir, 
 			   const ElementTransformation & aeltrans, 
@@ -911,11 +940,15 @@ namespace ngfem
 
     INLINE MappedIntegrationRule (const IntegrationRule & air, 
                                   const ElementTransformation & aeltrans, 
-                                  FlatArray< MappedIntegrationPoint<DIM_ELEMENT, DIM_SPACE> > amips)
+                                  FlatArray< MappedIntegrationPoint<DIM_ELEMENT, DIM_SPACE> > amips,
+                                  double * asoa = nullptr, int asoadist = 0)
       : BaseMappedIntegrationRule (air, aeltrans), mips(amips)
     {
       baseip = (char*)(void*)(BaseMappedIntegrationPoint*)(&mips[0]);
       incr = (char*)(void*)(&mips[1]) - (char*)(void*)(&mips[0]);
+      soa = asoa;
+      soadist = asoadist;
+      soadim = asoa ? DIMR : 0;
     }
     
     INLINE MappedIntegrationPoint<DIM_ELEMENT, DIM_SPACE> & operator[] (int i) const
@@ -925,8 +958,31 @@ namespace ngfem
 
     INLINE MappedIntegrationRule Range(int first, int next)
     {
-      return MappedIntegrationRule (ir.Range(first,next), eltrans, mips.Range(first,next));
+      return MappedIntegrationRule (ir.Range(first,next), eltrans, mips.Range(first,next),
+                                    soa ? soa+first : nullptr, soadist);
     }
+
+    /// Jacobi matrices, row i*DIMS+j is entry (i,j)
+    INLINE SliceMatrix<> GetJacobianSoA () const
+    { return SliceMatrix<> (soa ? DIMR*DIMS : 0, Size(), soadist, soa+SOA_JAC*soadist); }
+    /// (pseudo)inverse Jacobi matrices, row i*DIMR+j is entry (i,j)
+    INLINE SliceMatrix<> GetJacobianInverseSoA () const
+    { return SliceMatrix<> (soa ? DIMS*DIMR : 0, Size(), soadist, soa+SOA_IJAC*soadist); }
+    ///
+    INLINE FlatVector<> GetJacobiDetSoA () const
+    { return FlatVector<> (soa ? Size() : 0, soa+SOA_DET*soadist); }
+    /// normal vectors, for boundary rules
+    INLINE SliceMatrix<> GetNVSoA () const
+    { return SliceMatrix<> (soa ? DIMR : 0, Size(), soadist, soa+SOA_NV*soadist); }
+
+    /**
+       Computes determinants, inverses, weights and normals from the
+       points and Jacobians in the SoA rows, and fills the mapped
+       integration points.
+     */
+    void ComputeSoA ();
+    /// copies points and Jacobians of the mapped integration points to the SoA rows, and calls ComputeSoA
+    void ComputeSoAFromPoints ();
   };
 
 
@@ -62,5 +62,145 @@ namespace ngfem
   }
   
   
+  /* ******************** L2HexSumFactorization ******************** */
+
+  bool L2HexSumFactorization :: Applicable (const FiniteElement & fel)
+  {
+    return dynamic_cast<const L2HighOrderFE<ET_HEX>*> (&fel) != NULL;
+  }
+
+  // Legendre polynomials in 2x-1 and their derivatives in the points of the 1D rule
+  static void CalcShapes1D (int p, const IntegrationRule & ir1d, 
+                            FlatMatrix<> shape, FlatMatrix<> dshape)
+  {
+    ArrayMem<AutoDiff<1>, 20> pol(p+1);
+    for (int q = 0; q < ir1d.GetNIP(); q++)
+      {
+        AutoDiff<1> x (ir1d[q](0), 0);
+        LegendrePolynomial (p, 2*x-1, pol);
+        for (int i = 0; i <= p; i++)
+          {
+            shape(q,i) = pol[i].Value();
+            dshape(q,i) = pol[i].DValue(0);
+          }
+      }
+  }
+
+  // 1D shape matrices for all three directions
+  class L2HexShapes1D
+  {
+  public:
+    FlatMatrix<> shape[3], dshape[3];
+    L2HexShapes1D (const FiniteElement & fel, int intorder, LocalHeap & lh)
+    {
+      INT<3> p = static_cast<const L2HighOrderFE<ET_HEX>&> (fel).GetOrderInner();
+      const IntegrationRule & ir1d = SelectIntegrationRule (ET_SEGM, intorder);
+      for (int k = 0; k < 3; k++)
+        {
+          shape[k].AssignMemory (ir1d.GetNIP(), p[k]+1, lh);
+          dshape[k].AssignMemory (ir1d.GetNIP(), p[k]+1, lh);
+          CalcShapes1D (p[k], ir1d, shape[k], dshape[k]);
+        }
+    }
+  };
+
+  // u(qx,qy,qz) = sum_ijk ax(qx,i) ay(qy,j) az(qz,k) c(i,j,k)
+  static void TPApply (FlatMatrix<> ax, FlatMatrix<> ay, FlatMatrix<> az,
+                       FlatVector<> c, FlatVector<> u, LocalHeap & lh)
+  {
+    HeapReset hr(lh);
+    int nx = ax.Width(), ny = ay.Width(), nz = az.Width();
+    int mx = ax.Height(), my = ay.Height(), mz = az.Height();
+
+    FlatMatrix<> t1(nx*ny, mz, lh);
+    t1 = FlatMatrix<> (nx*ny, nz, &c(0)) * Trans (az);
+
+    FlatMatrix<> t2(nx, my*mz, lh);
+    for (int i = 0; i < nx; i++)
+      {
+        FlatMatrix<> t2i(my, mz, &t2(i,0));
+        t2i = ay * t1.Rows(i*ny, (i+1)*ny);
+      }
+
+    FlatMatrix<> hu(mx, my*mz, &u(0));
+    hu = ax * t2;
+  }
+
+  // c(i,j,k) = sum_q ax(qx,i) ay(qy,j) az(qz,k) u(qx,qy,qz)
+  static void TPApplyTrans (FlatMatrix<> ax, FlatMatrix<> ay, FlatMatrix<> az,
+                            FlatVector<> u, FlatVector<> c, LocalHeap & lh)
+  {
+    HeapReset hr(lh);
+    int nx = ax.Width(), ny = ay.Width(), nz = az.Width();
+    int mx = ax.Height(), my = ay.Height(), mz = az.Height();
+
+    FlatMatrix<> t2(nx, my*mz, lh);
+    t2 = Trans (ax) * FlatMatrix<> (mx, my*mz, &u(0));
+
+    FlatMatrix<> t1(nx*ny, mz, lh);
+    for (int i = 0; i < nx; i++)
+      {
+        FlatMatrix<> t2i(my, mz, &t2(i,0));
+        t1.Rows(i*ny, (i+1)*ny) = Trans (ay) * t2i;
+      }
+
+    FlatMatrix<> hc(nx*ny, nz, &c(0));
+    hc = t1 * az;
+  }
+
+
+  void L2HexSumFactorization :: 
+  Evaluate (const FiniteElement & fel, int intorder,
+            FlatVector<> coefs, FlatVector<> vals, LocalHeap & lh)
+  {
+    HeapReset hr(lh);
+    L2HexShapes1D s(fel, intorder, lh);
+    TPApply (s.shape[0], s.shape[1], s.shape[2], coefs, vals, lh);
+  }
+
+  void L2HexSumFactorization :: 
+  EvaluateTrans (const FiniteElement & fel, int intorder,
+                 FlatVector<> vals, FlatVector<> coefs, LocalHeap & lh)
+  {
+    HeapReset hr(lh);
+    L2HexShapes1D s(fel, intorder, lh);
+    TPApplyTrans (s.shape[0], s.shape[1], s.shape[2], vals, coefs, lh);
+  }
+
+  void L2HexSumFactorization :: 
+  EvaluateGrad (const FiniteElement & fel, int intorder,
+                FlatVector<> coefs, FlatMatrixFixWidth<3> grads, LocalHeap & lh)
+  {
+    HeapReset hr(lh);
+    L2HexShapes1D s(fel, intorder, lh);
+    FlatVector<> hv(grads.Height(), lh);
+    for (int k = 0; k < 3; k++)
+      {
+        TPApply ( (k == 0) ? s.dshape[0] : s.shape[0],
+                  (k == 1) ? s.dshape[1] : s.shape[1],
+                  (k == 2) ? s.dshape[2] : s.shape[2], coefs, hv, lh);
+        grads.Col(k) = hv;
+      }
+  }
+
+  void L2HexSumFactorization :: 
+  EvaluateGradTrans (const FiniteElement & fel, int intorder,
+                     FlatMatrixFixWidth<3> grads, FlatVector<> coefs, LocalHeap & lh)
+  {
+    HeapReset hr(lh);
+    L2HexShapes1D s(fel, intorder, lh);
+    FlatVector<> hv(grads.Height(), lh);
+    FlatVector<> hc(coefs.Size(), lh);
+    coefs = 0.0;
+    for (int k = 0; k < 3; k++)
+      {
+        hv = grads.Col(k);
+        TPApplyTrans ( (k == 0) ? s.dshape[0] : s.shape[0],
+                       (k == 1) ? s.dshape[1] : s.shape[1],
+                       (k == 2) ? s.dshape[2] : s.shape[2], hv, hc, lh);
+        coefs += hc;
+      }
+  }
+
 }
 
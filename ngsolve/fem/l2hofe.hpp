@@ -87,6 +87,8 @@ namespace ngfem
 
     /// different orders in differnt directions
     virtual void SetOrder (INT<DIM> p)  { order_inner = p; }
+    ///
+    INT<DIM> GetOrderInner () const { return order_inner; }
 
     virtual void ComputeNDof()
     {
@@ -118,6 +120,35 @@ namespace ngfem
     HD NGS_DLL_HEADER virtual void GetDiagMassMatrix (FlatVector<> mass) const;
   };
 
+
+
+  /**
+     Sum factorization for L2HighOrderFE<ET_HEX>.
+     The shape functions are products of Legendre polynomials in x, y and z,
+     and IntegrationRule(ET_HEX, intorder) is the tensor product of the 
+     segment rule. Evaluation in all points costs O(p^4) instead of O(p^6).
+     Gradients are w.r.t. reference coordinates.
+  */
+  class NGS_DLL_HEADER L2HexSumFactorization
+  {
+  public:
+    /// is fel a L2HighOrderFE<ET_HEX> ?
+    static bool Applicable (const FiniteElement & fel);
+
+    /// values in the points of IntegrationRule(ET_HEX, intorder)
+    static void Evaluate (const FiniteElement & fel, int intorder,
+                          FlatVector<> coefs, FlatVector<> vals, LocalHeap & lh);
+    ///
+    static void EvaluateTrans (const FiniteElement & fel, int intorder,
+                               FlatVector<> vals, FlatVector<> coefs, LocalHeap & lh);
+    /// reference gradients in the points of IntegrationRule(ET_HEX, intorder)
+    static void EvaluateGrad (const FiniteElement & fel, int intorder,
+                              FlatVector<> coefs, FlatMatrixFixWidth<3> grads, LocalHeap & lh);
+    ///
+    static void EvaluateGradTrans (const FiniteElement & fel, int intorder,
+                                   FlatMatrixFixWidth<3> grads, FlatVector<> coefs, LocalHeap & lh);
+  };
+
 }
 
 
@@ -148,13 +148,16 @@ void NGS_DLL_HEADER ExportNgfem() {
   bp::class_<BilinearFormIntegrator, shared_ptr<BilinearFormIntegrator>, boost::noncopyable>
     ("BFI", bp::no_init)
     .def("__init__", bp::make_constructor
-         (FunctionPointer ([](string name, int dim, shared_ptr<CoefficientFunction> coef, bool imag)
+         (FunctionPointer ([](string name, int dim, shared_ptr<CoefficientFunction> coef, bool imag,
+                              const Flags & flags)
                            {
                              auto bfi = GetIntegrators().CreateBFI (name, dim, coef);
 
                              if (!bfi) cerr << "undefined integrator '" << name 
                                             << "' in " << dim << " dimension having 1 coefficient"
                                             << endl;
+                             else
+                               bfi -> SetFlags (flags);
 
                              if (imag)
                                bfi = make_shared<ComplexBilinearFormIntegrator> (bfi, Complex(0,1));
@@ -162,7 +165,8 @@ void NGS_DLL_HEADER ExportNgfem() {
                              return bfi;
                            }),
           bp::default_call_policies(),        // need it to use named arguments
-          (bp::arg("name")=NULL,bp::arg("dim")=2,bp::arg("coef"),bp::arg("imag")=false)))
+          (bp::arg("name")=NULL,bp::arg("dim")=2,bp::arg("coef"),bp::arg("imag")=false,
+           bp::arg("flags")=bp::dict())))
     
     .def("CalcElementMatrix", 
          static_cast<void(BilinearFormIntegrator::*) (const FiniteElement&, 
@@ -228,8 +228,29 @@ namespace ngfem
   CalcMappedDShape (const MappedIntegrationRule<DIM,DIM> & mir, 
 		    SliceMatrix<> dshape) const
   {
+    if (!mir.HasSoA())
+      {
+        for (int i = 0; i < mir.Size(); i++)
+          T_ScalarFiniteElement::CalcMappedDShape (mir[i], dshape.Cols(i*DIM,(i+1)*DIM));
+        return;
+      }
+
+    // inverse Jacobians from the SoA rows of the rule
+    SliceMatrix<> ijac = mir.GetJacobianInverseSoA();
     for (int i = 0; i < mir.Size(); i++)
-      T_ScalarFiniteElement::CalcMappedDShape (mir[i], dshape.Cols(i*DIM,(i+1)*DIM));
+      {
+        Vec<DIM, AutoDiff<DIM> > adp;
+        for (int k = 0; k < DIM; k++)
+          {
+            adp[k].Value() = mir.IR()[i](k);
+            for (int j = 0; j < DIM; j++)
+              adp[k].DValue(j) = ijac(k*DIM+j, i);
+          }
+
+        SliceMatrix<> dshapei = dshape.Cols(i*DIM,(i+1)*DIM);
+        T_CalcShape (&adp(0), SBLambda ([&] (int j, AutoDiff<DIM> shape)
+                                        { shape.StoreGradient (&dshapei(j,0)) ; }));
+      }
   }
 
 
@@ -0,0 +1,588 @@
+/*********************************************************************/
+/* File:   aggregationamg.cpp                                        */
+/* Date:   Oct. 2026                                                 */
+/*********************************************************************/
+
+/*
+   Smoothed aggregation AMG
+*/
+
+#include <la.hpp>
+
+namespace ngla
+{
+
+  // size of an entry, for the strength of connection
+  inline double AMGStrength (double a) { return fabs (a); }
+
+  template <int N>
+  inline double AMGStrength (const Mat<N,N,double> & a)
+  {
+    double sum = 0;
+    for (int i = 0; i < N; i++)
+      for (int j = 0; j < N; j++)
+        sum += sqr (a(i,j));
+    return sqrt (sum);
+  }
+
+  // scalar representative of an entry, the prolongation is the same for all components
+  inline double AMGScalar (double a) { return a; }
+
+  template <int N>
+  inline double AMGScalar (const Mat<N,N,double> & a)
+  {
+    double sum = 0;
+    for (int i = 0; i < N; i++)
+      sum += a(i,i);
+    return sum / N;
+  }
+
+  // random but reproducible priorities for the independent set
+  inline unsigned int AMGHash (unsigned int i)
+  {
+    i = ((i >> 16) ^ i) * 0x45d9f3b;
+    i = ((i >> 16) ^ i) * 0x45d9f3b;
+    return (i >> 16) ^ i;
+  }
+
+
+
+  template <class TM, class TV>
+  AggregationAMG<TM,TV> ::
+  AggregationAMG (const SparseMatrixSymmetric<TM,TV> & amat,
+                  const BitArray * afreedofs,
+                  double theta, int maxlevels, int coarsesize,
+                  int asmoothingsteps, int alevel)
+    : mat(amat), freedofs(afreedofs), level(alevel), smoothingsteps(asmoothingsteps)
+  {
+    static Timer t ("AggregationAMG - setup");
+    static Timer tagg ("AggregationAMG - aggregates");
+    static Timer tprol ("AggregationAMG - prolongation");
+    static Timer trestrict ("AggregationAMG - coarse matrix");
+    static Timer tsmoother ("AggregationAMG - smoother");
+    RegionTimer reg(t);
+
+    int n = mat.Height();
+    int nfree = freedofs ? freedofs->NumSet() : n;
+
+    cout << IM(3) << "AMG level " << level << ": " << nfree << " dofs" << endl;
+
+    int nagg = 0;
+    Table<int> strong;
+    Table<double> strong_val;
+    Array<double> diag;
+
+    if (nfree > coarsesize && level+1 < maxlevels)
+      {
+        RegionTimer reg(tagg);
+        CalcStrongConnections (theta, strong, strong_val, diag);
+        nagg = CalcAggregates (strong, strong_val);
+      }
+
+    // coarsening stagnates, e.g. for a (nearly) diagonal matrix
+    if (nagg == 0 || nagg > 0.8 * nfree)
+      {
+        inv = mat.InverseMatrix (freedofs);
+        return;
+      }
+
+    {
+      RegionTimer reg(tprol);
+      CalcProlongation (strong, strong_val, diag, nagg);
+    }
+
+    {
+      RegionTimer reg(trestrict);
+      coarsemat = shared_ptr<SparseMatrixSymmetric<TM,TV>>
+        (dynamic_cast<SparseMatrixSymmetric<TM,TV>*> (mat.Restrict (*prol)));
+      coarsemat -> SetInverseType (mat.GetInverseType());
+    }
+
+    {
+      RegionTimer reg(tsmoother);
+      // the smoother deletes the table
+      Array<int> cnt(n);
+      for (int i = 0; i < n; i++)
+        cnt[i] = (!freedofs || freedofs->Test(i)) ? 1 : 0;
+      Table<int> * blocks = new Table<int> (cnt);
+      for (int i = 0; i < n; i++)
+        if (cnt[i]) (*blocks)[i][0] = i;
+      smoother = mat.CreateBlockJacobiPrecond (*blocks);
+    }
+
+    // coarse matrices are denser, with smaller entries per connection
+    coarseamg = make_shared<AggregationAMG<TM,TV>>
+      (*coarsemat, nullptr, theta/2, maxlevels, coarsesize, smoothingsteps, level+1);
+  }
+
+
+  template <class TM, class TV>
+  AggregationAMG<TM,TV> :: ~AggregationAMG ()
+  {
+    ;
+  }
+
+
+
+  /*
+    j is strongly connected to i if |a_ij|^2 > theta^2 |a_ii| |a_jj|.
+    Weak connections are lumped to the diagonal, so that the filtered
+    matrix keeps the row sums of A. Dofs which are not free are left out.
+  */
+  template <class TM, class TV>
+  void AggregationAMG<TM,TV> ::
+  CalcStrongConnections (double theta, Table<int> & strong,
+                         Table<double> & strong_val, Array<double> & diag) const
+  {
+    int n = mat.Height();
+
+    Array<size_t> first(n+1);
+    first[0] = 0;
+    for (int i = 0; i < n; i++)
+      first[i+1] = first[i] + mat.GetRowIndices(i).Size();
+
+    Array<double> dnorm(n);
+    diag.SetSize (n);
+    Array<bool> isstrong(first[n]);
+
+#pragma omp parallel for
+    for (int i = 0; i < n; i++)
+      {
+        dnorm[i] = 0;
+        diag[i] = 0;
+        if (freedofs && !freedofs->Test(i)) continue;
+        FlatArray<int> ind = mat.GetRowIndices(i);
+        FlatVector<TM> val = mat.GetRowValues(i);
+        for (int k = 0; k < ind.Size(); k++)
+          if (ind[k] == i)
+            {
+              dnorm[i] = AMGStrength (val(k));
+              diag[i] = AMGScalar (val(k));
+            }
+      }
+
+#pragma omp parallel for
+    for (int i = 0; i < n; i++)
+      {
+        FlatArray<int> ind = mat.GetRowIndices(i);
+        FlatVector<TM> val = mat.GetRowValues(i);
+        for (int k = 0; k < ind.Size(); k++)
+          {
+            int j = ind[k];
+            isstrong[first[i]+k] = (j != i) && dnorm[i] > 0 && dnorm[j] > 0 &&
+              sqr (AMGStrength (val(k))) > sqr (theta) * dnorm[i] * dnorm[j];
+          }
+      }
+
+    TableCreator<int> creator(n);
+    for ( ; !creator.Done(); creator++)
+      for (int i = 0; i < n; i++)
+        {
+          FlatArray<int> ind = mat.GetRowIndices(i);
+          for (int k = 0; k < ind.Size(); k++)
+            if (isstrong[first[i]+k])
+              {
+                creator.Add (i, ind[k]);
+                creator.Add (ind[k], i);
+              }
+        }
+    strong = creator.MoveTable();
+
+    // weights in the same order, lumping of the weak connections
+    Array<int> cnt(n);
+    for (int i = 0; i < n; i++)
+      cnt[i] = strong[i].Size();
+    strong_val = Table<double> (cnt);
+    cnt = 0;
+
+    for (int i = 0; i < n; i++)
+      {
+        FlatArray<int> ind = mat.GetRowIndices(i);
+        FlatVector<TM> val = mat.GetRowValues(i);
+        for (int k = 0; k < ind.Size(); k++)
+          {
+            int j = ind[k];
+            if (j == i || dnorm[i] == 0 || dnorm[j] == 0) continue;
+            double aij = AMGScalar (val(k));
+            if (isstrong[first[i]+k])
+              {
+                strong_val[i][cnt[i]++] = aij;
+                strong_val[j][cnt[j]++] = aij;
+              }
+            else
+              {
+                diag[i] += aij;
+                diag[j] += aij;
+              }
+          }
+      }
+  }
+
+
+
+  /*
+    Roots are a maximal independent set of distance 2 in the graph of strong
+    connections, found by Luby-type rounds: an undecided dof becomes a root
+    if its priority is the largest of the undecided dofs within distance 2.
+    Every round consists of independent loops over the dofs, and the result
+    does not depend on the number of threads.
+
+    The neighbours of a root join its aggregate, there is at most one root
+    within distance 1. The remaining dofs join the aggregate of their
+    strongest neighbour. Dofs without strong connections are left to the
+    smoother.
+  */
+  template <class TM, class TV>
+  int AggregationAMG<TM,TV> ::
+  CalcAggregates (const Table<int> & strong, const Table<double> & strong_val)
+  {
+    enum { UNDECIDED = 0, ROOT = 1, DECIDED = 2 };
+    typedef unsigned long long TPRIO;
+
+    int n = mat.Height();
+
+    Array<int> state(n);
+    Array<TPRIO> prio(n), m1(n);
+    Array<bool> newroot(n), nearroot(n);
+
+#pragma omp parallel for
+    for (int i = 0; i < n; i++)
+      {
+        state[i] = strong[i].Size() ? UNDECIDED : DECIDED;
+        prio[i] = (TPRIO(AMGHash(i) & 0x7fffffff) << 32) + TPRIO(i) + 1;
+      }
+
+    while (true)
+      {
+        // largest undecided priority within distance 1
+#pragma omp parallel for
+        for (int i = 0; i < n; i++)
+          {
+            TPRIO m = (state[i] == UNDECIDED) ? prio[i] : 0;
+            for (int j : strong[i])
+              if (state[j] == UNDECIDED) m = max2 (m, prio[j]);
+            m1[i] = m;
+          }
+
+        // ... within distance 2
+#pragma omp parallel for
+        for (int i = 0; i < n; i++)
+          {
+            newroot[i] = false;
+            if (state[i] != UNDECIDED) continue;
+            TPRIO m = m1[i];
+            for (int j : strong[i])
+              m = max2 (m, m1[j]);
+            newroot[i] = (m == prio[i]);
+          }
+
+#pragma omp parallel for
+        for (int i = 0; i < n; i++)
+          {
+            bool nr = newroot[i];
+            for (int j : strong[i])
+              nr = nr || newroot[j];
+            nearroot[i] = nr;
+          }
+
+        int undecided = 0;
+#pragma omp parallel for reduction(+:undecided)
+        for (int i = 0; i < n; i++)
+          {
+            if (state[i] != UNDECIDED) continue;
+            if (newroot[i])
+              state[i] = ROOT;
+            else
+              {
+                bool nr = nearroot[i];
+                for (int j : strong[i])
+                  nr = nr || nearroot[j];
+                if (nr)
+                  state[i] = DECIDED;
+                else
+                  undecided++;
+              }
+          }
+
+        if (!undecided) break;
+      }
+
+    aggregate.SetSize (n);
+    int nagg = 0;
+    for (int i = 0; i < n; i++)
+      aggregate[i] = (state[i] == ROOT) ? nagg++ : -1;
+
+    // neighbours of the roots, roots are not written
+#pragma omp parallel for
+    for (int i = 0; i < n; i++)
+      if (state[i] != ROOT)
+        for (int j : strong[i])
+          if (state[j] == ROOT)
+            aggregate[i] = aggregate[j];
+
+    // distance 2, reads the aggregates of distance 1 only
+    Array<int> aggregate1 (aggregate);
+#pragma omp parallel for
+    for (int i = 0; i < n; i++)
+      if (aggregate1[i] == -1)
+        {
+          double maxval = 0;
+          for (int k = 0; k < strong[i].Size(); k++)
+            {
+              int j = strong[i][k];
+              if (aggregate1[j] != -1 && fabs (strong_val[i][k]) > maxval)
+                {
+                  maxval = fabs (strong_val[i][k]);
+                  aggregate[i] = aggregate1[j];
+                }
+            }
+        }
+
+    return nagg;
+  }
+
+
+
+  /*
+    Row i of the prolongation is
+      (1-omega) e_agg(i) - omega / d_i  sum_j a_ij e_agg(j)
+    over the strong connections j, with the filtered diagonal d_i.
+    omega = 4/3 / lambda, where the Gershgorin bound of D^-1 A_filtered
+    estimates its largest eigenvalue lambda.
+  */
+  template <class TM, class TV>
+  void AggregationAMG<TM,TV> ::
+  CalcProlongation (const Table<int> & strong, const Table<double> & strong_val,
+                    const Array<double> & diag, int nagg)
+  {
+    int n = mat.Height();
+
+    double lam = 1;
+#pragma omp parallel for reduction(max:lam)
+    for (int i = 0; i < n; i++)
+      if (aggregate[i] != -1 && diag[i] > 0)
+        {
+          double sum = diag[i];
+          for (double aij : strong_val[i])
+            sum += fabs (aij);
+          lam = max2 (lam, sum / diag[i]);
+        }
+    double omega = 4.0 / (3.0 * lam);
+
+    auto collect_row = [&] (int i, Array<int> & cols, Array<double> & vals)
+      {
+        cols.SetSize0();
+        vals.SetSize0();
+        if (aggregate[i] == -1) return;
+
+        cols.Append (aggregate[i]);
+        if (diag[i] <= 0)
+          {
+            vals.Append (1);
+            return;
+          }
+        vals.Append (1-omega);
+
+        FlatArray<int> ind = strong[i];
+        FlatArray<double> val = strong_val[i];
+        for (int k = 0; k < ind.Size(); k++)
+          {
+            int agg = aggregate[ind[k]];
+            if (agg == -1) continue;
+            double w = -omega * val[k] / diag[i];
+            int pos = cols.Pos (agg);
+            if (pos == -1)
+              {
+                cols.Append (agg);
+                vals.Append (w);
+              }
+            else
+              vals[pos] += w;
+          }
+      };
+
+    Array<int> cnt(n);
+#pragma omp parallel
+    {
+      Array<int> cols;
+      Array<double> vals;
+#pragma omp for
+      for (int i = 0; i < n; i++)
+        {
+          collect_row (i, cols, vals);
+          cnt[i] = cols.Size();
+        }
+    }
+
+    prol = make_shared<SparseMatrix<double>> (cnt, nagg);
+
+#pragma omp parallel
+    {
+      Array<int> cols;
+      Array<double> vals;
+#pragma omp for
+      for (int i = 0; i < n; i++)
+        {
+          collect_row (i, cols, vals);
+          for (int col : cols)
+            prol -> CreatePosition (i, col);
+          for (int k = 0; k < cols.Size(); k++)
+            (*prol)(i, cols[k]) = vals[k];
+        }
+    }
+
+    // the transpose for the restriction of the residual
+    TableCreator<int> creator(nagg);
+    for ( ; !creator.Done(); creator++)
+      for (int i = 0; i < n; i++)
+        for (int col : prol->GetRowIndices(i))
+          creator.Add (col, i);
+    prolt = creator.MoveTable();
+
+    Array<int> cntt(nagg);
+    for (int i = 0; i < nagg; i++)
+      cntt[i] = prolt[i].Size();
+    prolt_val = Table<double> (cntt);
+
+#pragma omp parallel for
+    for (int kk = 0; kk < nagg; kk++)
+      for (int ii = 0; ii < prolt[kk].Size(); ii++)
+        prolt_val[kk][ii] = (*prol)(prolt[kk][ii], kk);
+  }
+
+
+
+  template <class TM, class TV>
+  void AggregationAMG<TM,TV> :: Mult (const BaseVector & b, BaseVector & x) const
+  {
+    static Timer t ("AggregationAMG::Mult");
+    RegionTimer reg(t);
+
+    if (inv)
+      {
+        inv -> Mult (b, x);
+        return;
+      }
+
+    x = 0;
+    smoother -> GSSmooth (x, b, smoothingsteps);
+
+    AutoVector res = mat.CreateVector();
+    res = b;
+    mat.MultAdd (-1, x, res);
+
+    AutoVector cres = coarsemat->CreateVector();
+    AutoVector cx = coarsemat->CreateVector();
+
+    FlatVector<TV> fres = res.FV<TV>();
+    FlatVector<TV> fcres = cres.FV<TV>();
+    FlatVector<TV> fcx = cx.FV<TV>();
+    FlatVector<TV> fx = x.FV<TV>();
+
+    int nc = coarsemat->Height();
+#pragma omp parallel for
+    for (int kk = 0; kk < nc; kk++)
+      {
+        TV sum;
+        sum = 0.0;
+        FlatArray<int> fine = prolt[kk];
+        FlatArray<double> w = prolt_val[kk];
+        for (int ii = 0; ii < fine.Size(); ii++)
+          sum += w[ii] * fres(fine[ii]);
+        fcres(kk) = sum;
+      }
+
+    coarseamg -> Mult (cres, cx);
+
+    int n = mat.Height();
+#pragma omp parallel for
+    for (int i = 0; i < n; i++)
+      {
+        FlatArray<int> ind = prol->GetRowIndices(i);
+        FlatVector<double> val = prol->GetRowValues(i);
+        for (int k = 0; k < ind.Size(); k++)
+          fx(i) += val(k) * fcx(ind[k]);
+      }
+
+    smoother -> GSSmoothBack (x, b, smoothingsteps);
+  }
+
+
+
+  template <class TM, class TV>
+  int AggregationAMG<TM,TV> :: NLevels () const
+  {
+    return coarseamg ? coarseamg->NLevels()+1 : 1;
+  }
+
+  template <class TM, class TV>
+  size_t AggregationAMG<TM,TV> :: NZE () const
+  {
+    return mat.NZE() + (coarseamg ? coarseamg->NZE() : 0);
+  }
+
+  template <class TM, class TV>
+  double AggregationAMG<TM,TV> :: OperatorComplexity () const
+  {
+    return double (NZE()) / mat.NZE();
+  }
+
+  template <class TM, class TV>
+  void AggregationAMG<TM,TV> :: PrintReport (ostream & ost) const
+  {
+    if (level == 0)
+      ost << "AMG levels = " << NLevels()
+          << ", operator complexity = " << OperatorComplexity() << endl;
+    ost << "level " << level << ": size = " << mat.Height()
+        << ", nze = " << mat.NZE() << (inv ? ", direct solver" : "") << endl;
+    if (coarseamg)
+      coarseamg -> PrintReport (ost);
+  }
+
+  template <class TM, class TV>
+  void AggregationAMG<TM,TV> :: MemoryUsage (Array<MemoryUsageStruct*> & mu) const
+  {
+    if (prol)
+      mu.Append (new MemoryUsageStruct ("AMG prolongation",
+                                        prol->NZE()*(2*sizeof(double)+2*sizeof(int)),
+                                        1));
+    if (coarsemat)
+      coarsemat -> MemoryUsage (mu);
+    if (coarseamg)
+      coarseamg -> MemoryUsage (mu);
+  }
+
+
+
+  shared_ptr<BaseAggregationAMG>
+  CreateAggregationAMG (const BaseMatrix & mat, const BitArray * freedofs,
+                        double theta, int maxlevels, int coarsesize, int smoothingsteps)
+  {
+    if (auto smat = dynamic_cast<const SparseMatrixSymmetric<double,double>*> (&mat))
+      return make_shared<AggregationAMG<double,double>>
+        (*smat, freedofs, theta, maxlevels, coarsesize, smoothingsteps);
+
+#if MAX_SYS_DIM >= 2
+    if (auto smat = dynamic_cast<const SparseMatrixSymmetric<Mat<2,2,double>,Vec<2,double>>*> (&mat))
+      return make_shared<AggregationAMG<Mat<2,2,double>,Vec<2,double>>>
+        (*smat, freedofs, theta, maxlevels, coarsesize, smoothingsteps);
+#endif
+#if MAX_SYS_DIM >= 3
+    if (auto smat = dynamic_cast<const SparseMatrixSymmetric<Mat<3,3,double>,Vec<3,double>>*> (&mat))
+      return make_shared<AggregationAMG<Mat<3,3,double>,Vec<3,double>>>
+        (*smat, freedofs, theta, maxlevels, coarsesize, smoothingsteps);
+#endif
+
+    throw Exception (string ("AggregationAMG: needs a real symmetric sparse matrix, type = ")
+                     + typeid(mat).name());
+  }
+
+
+  template class AggregationAMG<double,double>;
+#if MAX_SYS_DIM >= 2
+  template class AggregationAMG<Mat<2,2,double>,Vec<2,double>>;
+#endif
+#if MAX_SYS_DIM >= 3
+  template class AggregationAMG<Mat<3,3,double>,Vec<3,double>>;
+#endif
+}
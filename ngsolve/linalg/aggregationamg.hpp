@@ -0,0 +1,120 @@
+#ifndef FILE_AGGREGATION_AMG
+#define FILE_AGGREGATION_AMG
+
+/* *************************************************************************/
+/* File:   aggregationamg.hpp                                              */
+/* Date:   Oct. 2026                                                       */
+/* *************************************************************************/
+
+namespace ngla
+{
+
+  /**
+     Smoothed aggregation AMG, needs nothing but the assembled matrix.
+  */
+  class NGS_DLL_HEADER BaseAggregationAMG : public BaseMatrix
+  {
+  public:
+    virtual ~BaseAggregationAMG () { ; }
+
+    /// number of levels, including the coarsest
+    virtual int NLevels () const = 0;
+    /// non-zero entries of the matrices of all levels
+    virtual size_t NZE () const = 0;
+    /// NZE of all levels / NZE of the finest level
+    virtual double OperatorComplexity () const = 0;
+    /// size and non-zero entries per level
+    virtual void PrintReport (ostream & ost) const = 0;
+  };
+
+
+  /**
+     Smoothed aggregation AMG for symmetric sparse matrices.
+
+     Aggregates are built from the strong connections of the matrix by a
+     parallel maximal independent set of distance 2. The tentative
+     prolongation is constant on every aggregate, with the same weight for
+     all components of a block, and it is smoothed by one damped Jacobi
+     step of the filtered matrix. Coarse matrices are the Galerkin products
+     from SparseMatrixSymmetric::Restrict. Levels are smoothed by the
+     colored Gauss-Seidel of BlockJacobiPrecondSymmetric, with one dof per
+     block, the coarsest level is solved by the inverse type of the matrix.
+  */
+  template <class TM, class TV>
+  class NGS_DLL_HEADER AggregationAMG : public BaseAggregationAMG
+  {
+    const SparseMatrixSymmetric<TM,TV> & mat;
+    /// free dofs of the finest level, not copied
+    const BitArray * freedofs;
+    int level;
+    int smoothingsteps;
+
+    /// colored Gauss-Seidel with one block per free dof
+    shared_ptr<BaseBlockJacobiPrecond> smoother;
+
+    /// aggregate of every dof, -1 if not aggregated
+    Array<int> aggregate;
+    /// smoothed prolongation
+    shared_ptr<SparseMatrix<double>> prol;
+    /// fine dofs and weights of every coarse dof, for the restriction
+    Table<int> prolt;
+    Table<double> prolt_val;
+
+    shared_ptr<SparseMatrixSymmetric<TM,TV>> coarsemat;
+    shared_ptr<AggregationAMG<TM,TV>> coarseamg;
+    /// direct solver on the coarsest level
+    shared_ptr<BaseMatrix> inv;
+
+  public:
+    /**
+       theta ... strength of connection threshold, halved on every coarser level
+       maxlevels ... maximal number of levels
+       coarsesize ... levels with at most coarsesize free dofs are solved directly
+    */
+    AggregationAMG (const SparseMatrixSymmetric<TM,TV> & amat,
+                    const BitArray * afreedofs,
+                    double theta = 0.08, int maxlevels = 20,
+                    int coarsesize = 500, int asmoothingsteps = 1,
+                    int alevel = 0);
+
+    virtual ~AggregationAMG ();
+
+    virtual bool IsComplex() const { return false; }
+    virtual int VHeight() const { return mat.Height(); }
+    virtual int VWidth() const { return mat.Width(); }
+    virtual AutoVector CreateVector () const { return mat.CreateVector(); }
+
+    /// one V-cycle
+    virtual void Mult (const BaseVector & b, BaseVector & x) const;
+    virtual void MultTransAdd (double s, const BaseVector & x, BaseVector & y) const
+    {
+      MultAdd (s, x, y);
+    }
+
+    virtual int NLevels () const;
+    virtual size_t NZE () const;
+    virtual double OperatorComplexity () const;
+    virtual void PrintReport (ostream & ost) const;
+    virtual void MemoryUsage (Array<MemoryUsageStruct*> & mu) const;
+
+  protected:
+    /// strong connections in both directions, their weights, and the diagonal of the filtered matrix
+    void CalcStrongConnections (double theta, Table<int> & strong,
+                                Table<double> & strong_val, Array<double> & diag) const;
+    /// aggregates by a maximal independent set of distance 2, returns the number of aggregates
+    int CalcAggregates (const Table<int> & strong, const Table<double> & strong_val);
+    /// prolongation = (I - omega D^-1 A_filtered) P_tentative
+    void CalcProlongation (const Table<int> & strong, const Table<double> & strong_val,
+                           const Array<double> & diag, int nagg);
+  };
+
+
+  /// AMG for SparseMatrixSymmetric of double, Mat<2,2> and Mat<3,3> entries
+  extern NGS_DLL_HEADER shared_ptr<BaseAggregationAMG>
+  CreateAggregationAMG (const BaseMatrix & mat, const BitArray * freedofs,
+                        double theta = 0.08, int maxlevels = 20,
+                        int coarsesize = 500, int smoothingsteps = 1);
+
+}
+
+#endif
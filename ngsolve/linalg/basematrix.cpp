@@ -136,6 +136,31 @@ namespace ngla
     throw Exception (err.str());
   }
   
+  template <class SCAL>
+  void MultAddVectorByVector (const BaseMatrix & mat, double s, 
+                              const MultiVector<SCAL> & x, MultiVector<SCAL> & y)
+  {
+    auto hx = x.CreateVector();
+    auto hy = y.CreateVector();
+    for (int i = 0; i < x.NumVectors(); i++)
+      {
+        x.GetVector (i, hx);
+        y.GetVector (i, hy);
+        mat.MultAdd (s, hx, hy);
+        y.SetVector (i, hy);
+      }
+  }
+
+  void BaseMatrix :: MultAdd (double s, const MultiVector<double> & x, MultiVector<double> & y) const
+  {
+    MultAddVectorByVector (*this, s, x, y);
+  }
+
+  void BaseMatrix :: MultAdd (double s, const MultiVector<Complex> & x, MultiVector<Complex> & y) const
+  {
+    MultAddVectorByVector (*this, s, x, y);
+  }
+
   void BaseMatrix :: MultTransAdd (double s, const BaseVector & x, BaseVector & y) const
   {
     cout << "warning: BaseMatrix::MultTransAdd(double) calls MultAdd, ";
@@ -273,6 +298,7 @@ namespace ngla
       case SUPERLU_DIST:    return "superlu_dist";
       case MUMPS:           return "mumps";
       case MASTERINVERSE:   return "masterinverse";
+      case SPARSECHOLESKY_ND: return "sparsecholesky_nd";
       }
     return "";
   }
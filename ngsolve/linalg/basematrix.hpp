@@ -13,7 +13,7 @@ namespace ngla
 
 
   // sets the solver which is used for InverseMatrix
-  enum INVERSETYPE { PARDISO, PARDISOSPD, SPARSECHOLESKY, SUPERLU, SUPERLU_DIST, MUMPS, MASTERINVERSE };
+  enum INVERSETYPE { PARDISO, PARDISOSPD, SPARSECHOLESKY, SUPERLU, SUPERLU_DIST, MUMPS, MASTERINVERSE, SPARSECHOLESKY_ND };
   extern string GetInverseName (INVERSETYPE type);
 
   /**
@@ -96,6 +96,11 @@ namespace ngla
     /// y += s Trans(matrix) * x
     virtual void MultTransAdd (Complex s, const BaseVector & x, BaseVector & y) const;
 
+    /// y += s matrix * x for all vectors of the block. Default: vector by vector
+    virtual void MultAdd (double s, const MultiVector<double> & x, MultiVector<double> & y) const;
+    /// y += s matrix * x for all vectors of the block. Default: vector by vector
+    virtual void MultAdd (double s, const MultiVector<Complex> & x, MultiVector<Complex> & y) const;
+
 
 
 
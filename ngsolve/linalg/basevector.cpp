@@ -473,6 +473,8 @@ namespace ngla
 
 
   void BaseVector :: Cumulate () const { ; }
+  void BaseVector :: StartCumulate () const { ; }
+  void BaseVector :: FinishCumulate () const { Cumulate(); }
   void BaseVector :: Distribute() const { ; }
   PARALLEL_STATUS BaseVector :: GetParallelStatus () const { return NOT_PARALLEL; }
   void BaseVector :: SetParallelStatus (PARALLEL_STATUS stat) const { ; }
@@ -571,6 +573,233 @@ namespace ngla
   }
   
 
+  /* ************** fused kernels for the Krylov solvers *************** */
+
+  // shorter vectors are not worth a parallel region
+  static const int fused_parallel_size = 10000;
+
+  inline bool IsLocal (const BaseVector & v)
+  {
+    return v.GetParallelStatus() == NOT_PARALLEL;
+  }
+
+  inline void CheckFusedSize (const BaseVector & x, const BaseVector & v, const char * name)
+  {
+    if (x.Size() != v.Size())
+      throw Exception (string(name) + ": size of me = " + ToString(x.Size()) + 
+                       " != size of other = " + ToString(v.Size()));
+  }
+
+  inline double Abs2 (double x) { return x*x; }
+  inline double Abs2 (Complex x) { return norm(x); }
+
+
+  template <class SCAL>
+  void T_ScaleAdd (BaseVector & x, SCAL scal, const BaseVector & v, 
+                   SCAL scal2, const BaseVector * w)
+  {
+    static Timer t("BaseVector::ScaleAdd");
+    RegionTimer reg(t);
+
+    CheckFusedSize (x, v, "ScaleAdd");
+    if (w) CheckFusedSize (x, *w, "ScaleAdd");
+
+    if (!IsLocal(x) || !IsLocal(v) || (w && !IsLocal(*w)))
+      {
+        x.Scale (scal);
+        x.Add (1.0, v);
+        if (w) x.Add (scal2, *w);
+        return;
+      }
+
+    FlatVector<SCAL> fx = x.FV<SCAL>();
+    SCAL * px = fx.Addr(0);
+    const SCAL * pv = v.FV<SCAL>().Addr(0);
+    const SCAL * pw = w ? w->FV<SCAL>().Addr(0) : NULL;
+
+    ParallelVectorLoop (fx.Size(), fused_parallel_size, [=] (IntRange r, int tid)
+      {
+        if (pw)
+          {
+#pragma omp simd
+            for (int i = r.First(); i < r.Next(); i++)
+              px[i] = scal * px[i] + pv[i] + scal2 * pw[i];
+          }
+        else
+          {
+#pragma omp simd
+            for (int i = r.First(); i < r.Next(); i++)
+              px[i] = scal * px[i] + pv[i];
+          }
+      });
+  }
+
+  template <class SCAL>
+  double T_AddTwo (BaseVector & x, SCAL s1, const BaseVector & v1,
+                   BaseVector & y, SCAL s2, const BaseVector & v2, 
+                   bool calcnorm)
+  {
+    static Timer t("BaseVector::AddTwo");
+    RegionTimer reg(t);
+
+    CheckFusedSize (x, v1, "AddTwo");
+    CheckFusedSize (y, v2, "AddTwo");
+
+    if (!IsLocal(x) || !IsLocal(v1) || !IsLocal(y) || !IsLocal(v2) || x.Size() != y.Size())
+      {
+        x.Add (s1, v1);
+        y.Add (s2, v2);
+        return calcnorm ? y.L2Norm() : 0.0;
+      }
+
+    FlatVector<SCAL> fx = x.FV<SCAL>();
+    SCAL * px = fx.Addr(0);
+    SCAL * py = y.FV<SCAL>().Addr(0);
+    const SCAL * pv1 = v1.FV<SCAL>().Addr(0);
+    const SCAL * pv2 = v2.FV<SCAL>().Addr(0);
+
+    double sum = ParallelVectorSum<double> (fx.Size(), fused_parallel_size, 
+                                            [=] (IntRange r) -> double
+      {
+        double sum = 0;
+        if (calcnorm)
+          {
+#pragma omp simd reduction(+:sum)
+            for (int i = r.First(); i < r.Next(); i++)
+              {
+                px[i] += s1 * pv1[i];
+                SCAL hy = py[i] + s2 * pv2[i];
+                py[i] = hy;
+                sum += Abs2 (hy);
+              }
+          }
+        else
+          {
+#pragma omp simd
+            for (int i = r.First(); i < r.Next(); i++)
+              {
+                px[i] += s1 * pv1[i];
+                py[i] += s2 * pv2[i];
+              }
+          }
+        return sum;
+      });
+    return sqrt (sum);
+  }
+
+  template <class SCAL, bool CONJ>
+  SCAL T_AddInnerProduct (BaseVector & x, SCAL scal, const BaseVector & v,
+                          const BaseVector & w)
+  {
+    static Timer t("BaseVector::AddInnerProduct");
+    RegionTimer reg(t);
+
+    CheckFusedSize (x, v, "AddInnerProduct");
+    CheckFusedSize (x, w, "AddInnerProduct");
+
+    if (!IsLocal(x) || !IsLocal(v) || !IsLocal(w))
+      {
+        x.Add (scal, v);
+        if (CONJ)
+          return S_InnerProduct<ComplexConjugate> (x, w);
+        return S_InnerProduct<SCAL> (x, w);
+      }
+
+    FlatVector<SCAL> fx = x.FV<SCAL>();
+    SCAL * px = fx.Addr(0);
+    const SCAL * pv = v.FV<SCAL>().Addr(0);
+    const SCAL * pw = w.FV<SCAL>().Addr(0);
+
+    return ParallelVectorSum<SCAL> (fx.Size(), fused_parallel_size, 
+                                    [=] (IntRange r) -> SCAL
+      {
+        SCAL sum = 0.0;
+        for (int i = r.First(); i < r.Next(); i++)
+          {
+            SCAL hx = px[i] + scal * pv[i];
+            px[i] = hx;
+            sum += hx * ConjIf (pw[i], CONJ);
+          }
+        return sum;
+      });
+  }
+
+  template <>
+  double T_AddInnerProduct<double,false> (BaseVector & x, double scal, const BaseVector & v,
+                                          const BaseVector & w)
+  {
+    static Timer t("BaseVector::AddInnerProduct");
+    RegionTimer reg(t);
+
+    CheckFusedSize (x, v, "AddInnerProduct");
+    CheckFusedSize (x, w, "AddInnerProduct");
+
+    if (!IsLocal(x) || !IsLocal(v) || !IsLocal(w))
+      {
+        x.Add (scal, v);
+        return S_InnerProduct<double> (x, w);
+      }
+
+    FlatVector<double> fx = x.FVDouble();
+    double * px = fx.Addr(0);
+    const double * pv = v.FVDouble().Addr(0);
+    const double * pw = w.FVDouble().Addr(0);
+
+    return ParallelVectorSum<double> (fx.Size(), fused_parallel_size, 
+                                      [=] (IntRange r) -> double
+      {
+        double sum = 0;
+#pragma omp simd reduction(+:sum)
+        for (int i = r.First(); i < r.Next(); i++)
+          {
+            double hx = px[i] + scal * pv[i];
+            px[i] = hx;
+            sum += hx * pw[i];
+          }
+        return sum;
+      });
+  }
+
+
+  void ScaleAdd (BaseVector & x, double scal, const BaseVector & v)
+  { T_ScaleAdd (x, scal, v, 0.0, NULL); }
+  void ScaleAdd (BaseVector & x, Complex scal, const BaseVector & v)
+  { T_ScaleAdd (x, scal, v, Complex(0.0), NULL); }
+
+  void ScaleAdd (BaseVector & x, double scal, const BaseVector & v,
+                 double scal2, const BaseVector & w)
+  { T_ScaleAdd (x, scal, v, scal2, &w); }
+  void ScaleAdd (BaseVector & x, Complex scal, const BaseVector & v,
+                 Complex scal2, const BaseVector & w)
+  { T_ScaleAdd (x, scal, v, scal2, &w); }
+
+  void AddTwo (BaseVector & x, double s1, const BaseVector & v1,
+               BaseVector & y, double s2, const BaseVector & v2)
+  { T_AddTwo (x, s1, v1, y, s2, v2, false); }
+  void AddTwo (BaseVector & x, Complex s1, const BaseVector & v1,
+               BaseVector & y, Complex s2, const BaseVector & v2)
+  { T_AddTwo (x, s1, v1, y, s2, v2, false); }
+
+  double AddTwoL2Norm (BaseVector & x, double s1, const BaseVector & v1,
+                       BaseVector & y, double s2, const BaseVector & v2)
+  { return T_AddTwo (x, s1, v1, y, s2, v2, true); }
+  double AddTwoL2Norm (BaseVector & x, Complex s1, const BaseVector & v1,
+                       BaseVector & y, Complex s2, const BaseVector & v2)
+  { return T_AddTwo (x, s1, v1, y, s2, v2, true); }
+
+  double AddInnerProduct (BaseVector & x, double scal, const BaseVector & v,
+                          const BaseVector & w)
+  { return T_AddInnerProduct<double,false> (x, scal, v, w); }
+  Complex AddInnerProduct (BaseVector & x, Complex scal, const BaseVector & v,
+                           const BaseVector & w, bool conjugate)
+  {
+    if (conjugate)
+      return T_AddInnerProduct<Complex,true> (x, scal, v, w);
+    return T_AddInnerProduct<Complex,false> (x, scal, v, w);
+  }
+
+
+
   template class S_BaseVector<double>;
   // template class S_BaseVector<Complex>;
   
@@ -333,6 +333,10 @@ namespace ngla
     */
   
     virtual void Cumulate () const;
+    /// split-phase Cumulate: post communication
+    virtual void StartCumulate () const;
+    /// split-phase Cumulate: wait for communication and add values
+    virtual void FinishCumulate () const;
     virtual void Distribute() const;
     virtual PARALLEL_STATUS GetParallelStatus () const;
     virtual void SetParallelStatus (PARALLEL_STATUS stat) const;
@@ -501,6 +505,12 @@ namespace ngla
     virtual void Cumulate () const 
     { vec -> Cumulate(); }
 
+    virtual void StartCumulate () const 
+    { vec -> StartCumulate(); }
+
+    virtual void FinishCumulate () const 
+    { vec -> FinishCumulate(); }
+
     virtual void Distribute() const
     { vec -> Distribute(); }
 
@@ -957,6 +967,113 @@ namespace ngla
     return v.L2Norm();
   }
 
+
+
+  /* ************** thread-parallel loops over vectors *************** */
+
+  inline double ConjIf (double x, bool conjugate) { return x; }
+  inline Complex ConjIf (Complex x, bool conjugate) { return conjugate ? conj(x) : x; }
+
+  /*
+    Calls func (range, tid) for one part of [0,n) per thread. Loops
+    shorter than minsize, and calls from inside a parallel region, run
+    as func (IntRange(0,n), 0). Results stored per tid, for up to
+    omp_get_max_threads() threads, and added up in tid order do not
+    depend on the scheduling.
+  */
+  template <typename TFUNC>
+  inline void ParallelVectorLoop (int n, int minsize, TFUNC func)
+  {
+    if (n < minsize || omp_in_parallel() || omp_get_max_threads() == 1)
+      {
+        func (IntRange (0, n), 0);
+        return;
+      }
+
+#pragma omp parallel
+    {
+      int tid = omp_get_thread_num();
+      int nt = omp_get_num_threads();
+      func (IntRange (size_t(n)*tid/nt, size_t(n)*(tid+1)/nt), tid);
+    }
+  }
+
+  /// sum of func (range) over the parts of ParallelVectorLoop, in thread order
+  template <typename T, typename TFUNC>
+  inline T ParallelVectorSum (int n, int minsize, TFUNC func)
+  {
+    ArrayMem<T,32> partial (omp_get_max_threads());
+    partial = T(0.0);
+    ParallelVectorLoop (n, minsize, [&] (IntRange r, int tid) 
+                        { partial[tid] = func (r); });
+
+    T sum(0.0);
+    for (int i = 0; i < partial.Size(); i++)
+      sum += partial[i];
+    return sum;
+  }
+
+
+
+  /* ************** fused kernels for the Krylov solvers *************** */
+
+  /*
+    Several vector operations in one pass through memory, thread-parallel 
+    for long vectors. Real scalars work on real and complex vectors.
+    Parallel vectors fall back to the single operations.
+  */
+
+  /// x = scal * x + v
+  NGS_DLL_HEADER void ScaleAdd (BaseVector & x, double scal, const BaseVector & v);
+  NGS_DLL_HEADER void ScaleAdd (BaseVector & x, Complex scal, const BaseVector & v);
+
+  /// x = scal * x + v + scal2 * w
+  NGS_DLL_HEADER void ScaleAdd (BaseVector & x, double scal, const BaseVector & v,
+                                double scal2, const BaseVector & w);
+  NGS_DLL_HEADER void ScaleAdd (BaseVector & x, Complex scal, const BaseVector & v,
+                                Complex scal2, const BaseVector & w);
+
+  /// x += s1 * v1,  y += s2 * v2
+  NGS_DLL_HEADER void AddTwo (BaseVector & x, double s1, const BaseVector & v1,
+                              BaseVector & y, double s2, const BaseVector & v2);
+  NGS_DLL_HEADER void AddTwo (BaseVector & x, Complex s1, const BaseVector & v1,
+                              BaseVector & y, Complex s2, const BaseVector & v2);
+
+  /// x += s1 * v1,  y += s2 * v2,  returns L2Norm (y)
+  NGS_DLL_HEADER double AddTwoL2Norm (BaseVector & x, double s1, const BaseVector & v1,
+                                      BaseVector & y, double s2, const BaseVector & v2);
+  NGS_DLL_HEADER double AddTwoL2Norm (BaseVector & x, Complex s1, const BaseVector & v1,
+                                      BaseVector & y, Complex s2, const BaseVector & v2);
+
+  /// x += scal * v, returns (x,w), or (x,conj(w)) for conjugate
+  NGS_DLL_HEADER double AddInnerProduct (BaseVector & x, double scal, const BaseVector & v,
+                                         const BaseVector & w);
+  NGS_DLL_HEADER Complex AddInnerProduct (BaseVector & x, Complex scal, const BaseVector & v,
+                                          const BaseVector & w, bool conjugate = false);
+
+  /// x += scal * v, returns S_InnerProduct<IPTYPE> (x, w)
+  template <class IPTYPE>
+  inline typename SCAL_TRAIT<IPTYPE>::SCAL 
+  S_AddInnerProduct (BaseVector & x, typename SCAL_TRAIT<IPTYPE>::SCAL scal, 
+                     const BaseVector & v, const BaseVector & w)
+  {
+    return AddInnerProduct (x, scal, v, w);
+  }
+
+  template <> inline Complex 
+  S_AddInnerProduct<ComplexConjugate> (BaseVector & x, Complex scal, 
+                                       const BaseVector & v, const BaseVector & w)
+  {
+    return AddInnerProduct (x, scal, v, w, true);
+  }
+
+  template <> inline Complex 
+  S_AddInnerProduct<ComplexConjugate2> (BaseVector & x, Complex scal, 
+                                        const BaseVector & v, const BaseVector & w)
+  {
+    return conj (AddInnerProduct (x, scal, v, w, true));
+  }
+
 }
 
 
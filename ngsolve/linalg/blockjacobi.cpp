@@ -12,25 +12,6 @@ namespace ngla
 {
   
 
-  template <typename Tarray>
-  int BinSearch(const Tarray & v, int i) {
-    int n = v.Size();
-    
-    int first = 0;
-    int last = n-1;
-    if(v[0]>i) return 0;
-    if(v[n-1] <= i) return n;
-    while(last-first>1) {
-        int m = (first+last)/2;
-        if(v[m]<i)
-            first = m;
-        else
-            last = m;
-    }
-    return first;
-}
-
-
 
   BaseBlockJacobiPrecond :: 
   BaseBlockJacobiPrecond (Table<int> & ablocktable)
@@ -602,6 +583,7 @@ namespace ngla
 	    int steps) const 
   {
     static Timer timer ("BlockJacobiPrecond::GSSmooth");
+    static Timer timercol ("BlockJacobiPrecond::GSSmooth - one color");
     RegionTimer reg(timer);
     timer.AddFlops (nze);
 
@@ -622,6 +604,7 @@ namespace ngla
 	    // #pragma omp for
 	    // for (int ii=0; ii<blocks.Size(); ii++)
 
+            timercol.Start();
 	    IntRange r(block_balancing[c][tid], block_balancing[c][tid+1]);
 	    for (int ii : r) 
 	      {
@@ -643,6 +626,7 @@ namespace ngla
 		for (int j = 0; j < bs; j++)
 		  fx(blocktable[i][j]) += hy(j);
 	      }
+            timercol.Stop();
 #pragma omp barrier
 	  }
     }
@@ -1098,6 +1082,7 @@ namespace ngla
   GSSmooth (BaseVector & x, const BaseVector & b, int steps) const 
   {
     static Timer timer ("BlockJacobiPrecondSymmetric::GSSmooth (parallel)");
+    static Timer timercol ("BlockJacobiPrecondSymmetric::GSSmooth - one color");
     RegionTimer reg(timer);
 
     FlatVector<TVX> fb = b.FV<TVX> ();
@@ -1121,9 +1106,11 @@ namespace ngla
 	  {
 	    FlatArray<int> blocks = block_coloring[c];
 	    
+            timercol.Start();
 	    IntRange r(block_balancing[c][tid], block_balancing[c][tid+1]);
 	    for (int ii : r) 
 	      SmoothBlock (blocks[ii], fx, /* fb, */ fy);
+            timercol.Stop();
 #pragma omp barrier
 	  }
     }
@@ -37,6 +37,7 @@ namespace ngla
     printrates = 0;
     sh = NULL;
     useseed = false;
+    pipelined = false;
   }
   
 
@@ -52,6 +53,7 @@ namespace ngla
     printrates = 0;
     sh = NULL;
     useseed = false;
+    pipelined = false;
   }
 
 
@@ -68,6 +70,7 @@ namespace ngla
     printrates = 0;
     sh = NULL;
     useseed = false;
+    pipelined = false;
   }
 
  
@@ -511,6 +514,187 @@ namespace ngla
   }
 
 
+  /*
+    local part of the inner product, the global sum over all processes 
+    is left to the caller. Vector status as in S_ParallelBaseVector::InnerProduct:
+    if both vectors have the same status, v1 is cumulated (or distributed)
+    first, a blocking exchange with the neighbours. In MultPipelined this
+    happens only without preconditioner, where C r = r is distributed like
+    r and A C r. With a preconditioner C r is cumulated, and the reduction
+    needs no further communication.
+  */
+  template <class IPTYPE>
+  inline typename SCAL_TRAIT<IPTYPE>::SCAL 
+  LocalInnerProduct (const BaseVector & v1, const BaseVector & v2)
+  {
+    typedef typename SCAL_TRAIT<IPTYPE>::SCAL SCAL;
+    PARALLEL_STATUS stat = v1.GetParallelStatus();
+    if (stat != NOT_PARALLEL && stat == v2.GetParallelStatus())
+      {
+        if (stat == DISTRIBUTED)
+          v1.Cumulate();
+        else
+          v1.Distribute();
+      }
+    return InnerProduct (v1.FV<SCAL>(), v2.FV<SCAL>());
+  }
+
+  template <>
+  inline Complex LocalInnerProduct<ComplexConjugate> (const BaseVector & v1, const BaseVector & v2)
+  {
+    PARALLEL_STATUS stat = v1.GetParallelStatus();
+    if (stat != NOT_PARALLEL && stat == v2.GetParallelStatus())
+      {
+        if (stat == DISTRIBUTED)
+          v1.Cumulate();
+        else
+          v1.Distribute();
+      }
+    return InnerProduct (v1.FVComplex(), Conj(v2.FVComplex()));
+  }
+
+  template <>
+  inline Complex LocalInnerProduct<ComplexConjugate2> (const BaseVector & v1, const BaseVector & v2)
+  {
+    return LocalInnerProduct<ComplexConjugate> (v2, v1);
+  }
+
+
+  template <class IPTYPE>
+  void CGSolver<IPTYPE> :: MultPipelined (const BaseVector & f, BaseVector & u) const
+  {
+    static Timer timer ("CG solver, pipelined");
+    RegionTimer reg (timer);
+
+    try
+      {
+	// Solve A u = f
+	if(sh)
+	  sh->SetThreadPercentage(0);
+
+        // r .. residual, w = A C r, 
+        // p, s = A p, q = C s, z = A q search directions
+        auto r = f.CreateVector();
+        auto cr = f.CreateVector();
+        auto w = f.CreateVector();
+        auto m = f.CreateVector();
+        auto nv = f.CreateVector();
+        auto p = f.CreateVector();
+        auto s = f.CreateVector();
+        auto q = f.CreateVector();
+        auto z = f.CreateVector();
+
+	int n = 0;
+	SCAL al = 1, alold = 1, be, gamma, gammaold = 1, delta;
+	double err;
+
+	if (initialize)
+	  {
+	    u = 0.0;
+	    r = f;
+	  }
+	else
+	  r = f - (*a) * u;
+
+	if (c)
+	  cr = (*c) * r;
+	else
+	  cr = r;
+        w = (*a) * cr;
+
+        bool parallel = r.GetParallelStatus() != NOT_PARALLEL;
+        Vec<2,SCAL> ips;
+        FlatArray<double> ipsd (2*sizeof(SCAL)/sizeof(double), (double*)&ips(0));
+
+        // gamma = (r, C r), delta = (A C r, C r): one reduction, overlapped with m = C w, nv = A m
+        auto start_reduction = [&] () -> MPI_Request
+          {
+            ips(0) = LocalInnerProduct<IPTYPE> (r, cr);
+            ips(1) = LocalInnerProduct<IPTYPE> (w, cr);
+            return parallel ? MyMPI_IAllReduce (ipsd) : MPI_REQUEST_NULL;
+          };
+        auto apply_operators = [&] ()
+          {
+            if (c)
+              m = (*c) * w;
+            else
+              m = w;
+            nv = (*a) * m;
+          };
+
+        MPI_Request request = start_reduction();
+        apply_operators();
+        if (parallel) MyMPI_Wait (request);
+        gamma = ips(0);
+        delta = ips(1);
+
+	if (printrates) cout << IM(1) << "0 " << sqrt(Abs(gamma)) << endl;
+
+	if(stop_absolute)
+	  err = prec * prec;
+	else
+	  err = prec * prec * ( (gamma == 0.0) ? 1 : Abs (gamma) );
+	
+	double lwstart = log( (gamma == 0.0) ? 1 : Abs(gamma) );
+	double lerr = log(err);
+	
+	while (n++ < maxsteps && Abs(gamma) > err && !(sh && sh->ShouldTerminate()))
+	  {
+            if (n == 1)
+              {
+                if (delta == 0.0) break;
+                al = gamma / delta;
+                z = nv;
+                q = m;
+                s = w;
+                p = cr;
+              }
+            else
+              {
+                be = gamma / gammaold;
+                SCAL denom = delta - be * gamma / alold;
+                if (denom == 0.0) break;
+                al = gamma / denom;
+                ScaleAdd (z, be, nv);
+                ScaleAdd (q, be, m);
+                ScaleAdd (s, be, w);
+                ScaleAdd (p, be, cr);
+              }
+
+            AddTwo (u, al, p, r, -al, s);
+            AddTwo (cr, -al, q, w, -al, z);
+
+            gammaold = gamma;
+            alold = al;
+
+            request = start_reduction();
+            apply_operators();
+            if (parallel) MyMPI_Wait (request);
+            gamma = ips(0);
+            delta = ips(1);
+
+	    if (printrates ) cout << IM(1) << n << " " << sqrt (Abs (gamma)) << endl;
+	    if ( sh )
+	      sh->SetThreadPercentage(100.*max2(double(n)/double(maxsteps),
+						(lwstart-log(Abs(gamma)))/(lwstart-lerr)));
+	  } 
+	
+	const_cast<int&> (steps) = n;
+      }
+
+    catch (exception & e)
+      {
+	throw Exception(e.what() +
+			string ("\ncaught in CGSolver::MultPipelined\n"));
+      }
+    catch (Exception & e)
+      {
+	e.Append ("in caught in CGSolver::MultPipelined\n");
+	throw;
+      }
+  }
+
+
   template <class IPTYPE>
   void CGSolver<IPTYPE> :: Mult (const BaseVector & f, BaseVector & u) const
   {
@@ -557,6 +741,12 @@ namespace ngla
 	//MultiMult(f,u,dim);
 	return;
       }
+
+    if (pipelined)
+      {
+        MultPipelined (f, u);
+        return;
+      }
  
     
     try
@@ -609,19 +799,28 @@ namespace ngla
 	    if (kss == 0.0) break;
 	    
 	    al = wd / kss;
-	    u += al * s;
-	    d -= al * w;
 
-	    if (c)
-	      w = (*c) * d;
+            // the parallel inner product cumulates its first argument,
+            // the fused (d,d) is only for sequential vectors
+            bool fused = !c && d.GetParallelStatus() == NOT_PARALLEL;
+	    if (fused)
+              {
+                u += al * s;
+                wdn = S_AddInnerProduct<IPTYPE> (d, -al, w, d);
+              }
 	    else
-	      w = d;
-	    wdn = S_InnerProduct<IPTYPE> (d, w);
+              {
+                AddTwo (u, al, s, d, -al, w);
+                if (c)
+                  w = (*c) * d;
+                else
+                  w = d;
+                wdn = S_InnerProduct<IPTYPE> (d, w);
+              }
 
 	    be = wdn / wd;
 	    
-	    s *= be;
-	    s += w;
+	    ScaleAdd (s, be, fused ? d : w);
 
 	    if (printrates ) cout << IM(1) << n << " " << sqrt (Abs (wdn)) << endl;
 	    if ( sh )
@@ -662,7 +861,6 @@ namespace ngla
 	auto r_tilde = f.CreateVector();
 	auto p = f.CreateVector();
 	auto p_tilde = f.CreateVector();
-	auto s = f.CreateVector();
 	auto s_tilde = f.CreateVector();
 	auto t = f.CreateVector();
 	auto v = f.CreateVector();
@@ -691,21 +889,19 @@ namespace ngla
 
 	v = (*a) * p_tilde;
 	alpha = rho_new / S_InnerProduct<IPTYPE> (r_tilde, v);
-	s = r - alpha * v;
 
-	err_i = L2Norm(s);
+        // s = r - alpha v is stored in r
+	AddTwo (u, alpha, p_tilde, r, -alpha, v);
+
 	if (c)
-	  s_tilde = (*c) * s;
+	  s_tilde = (*c) * r;
 	else
-	  s_tilde = s;
+	  s_tilde = r;
 
 	t = (*a) * s_tilde;
 
-	omega = S_InnerProduct<IPTYPE> (t, s) / S_InnerProduct<IPTYPE> (t, t);
-	u += alpha * p_tilde + omega * s_tilde;
-	r = s - omega * t;
-
-	err_i = L2Norm(r);
+	omega = S_InnerProduct<IPTYPE> (t, r) / S_InnerProduct<IPTYPE> (t, t);
+	err_i = AddTwoL2Norm (u, omega, s_tilde, r, -omega, t);
 	if (printrates) cout << IM(1) << "0 " << err_i << endl;
 
 
@@ -723,7 +919,7 @@ namespace ngla
 	    rho_old = rho_new;
 	    rho_new = S_InnerProduct<IPTYPE>(r_tilde, r);
 	    beta = (rho_new / rho_old ) * ( alpha / omega );
-	    p = r + beta * ( p - omega * v );
+	    ScaleAdd (p, beta, r, -beta*omega, v);
 
 	    if (c)
 	      p_tilde = (*c) * p;
@@ -732,10 +928,8 @@ namespace ngla
 	    
 	    v = (*a) * p_tilde;
 	    alpha = rho_new / S_InnerProduct<IPTYPE> (r_tilde, v);
-	    s = r - alpha * v;
 
-	    err_i = L2Norm(s);
-	    u += alpha * p_tilde;
+	    err_i = AddTwoL2Norm (u, alpha, p_tilde, r, -alpha, v);
 	    
 	    if ( err_i < err )
 	      {
@@ -743,17 +937,14 @@ namespace ngla
 	      }
 
 	    if (c)
-	      s_tilde = (*c) * s;
+	      s_tilde = (*c) * r;
 	    else
-	      s_tilde = s;
+	      s_tilde = r;
 
 	    t = (*a) * s_tilde;
 	    
-	    omega = S_InnerProduct<IPTYPE> (t, s) / S_InnerProduct<IPTYPE> (t, t);
-	    u +=  omega * s_tilde;
-	    r = s - omega * t;
-
-	    err_i = L2Norm(r);
+	    omega = S_InnerProduct<IPTYPE> (t, r) / S_InnerProduct<IPTYPE> (t, t);
+	    err_i = AddTwoL2Norm (u, omega, s_tilde, r, -omega, t);
 
 	    if (printrates ) cout << IM(1) << n << " " << err_i << endl;
 	    if(sh)
@@ -931,10 +1122,11 @@ namespace ngla
               h2(i,j) = h(i,j) = S_InnerProduct<IPTYPE> (*vi[i], av);
 
             w = av;
-            for (int i = 0; i <= j; i++)
+            for (int i = 0; i < j; i++)
               w -= h(i,j) * (*vi[i]);
+            SCAL ww = S_AddInnerProduct<IPTYPE> (w, -h(j,j), *vi[j], w);
 
-            v = (1.0 / sqrt (S_InnerProduct<IPTYPE> (w, w))) * w;
+            v = (1.0 / sqrt (ww)) * w;
             h2(j+1,j) = h(j+1,j) = S_InnerProduct<IPTYPE> (v, av);
 
             for (int i = 0; i < j; i++)
@@ -1313,6 +1505,457 @@ void QMRSolver<SCAL> :: Mult (const BaseVector & b, BaseVector & x) const
   
  
   
+  // the block solvers use X^H Y for the complex conjugate inner products
+  template <class IPTYPE> inline bool ConjugateBlockProduct () { return false; }
+  template <> inline bool ConjugateBlockProduct<ComplexConjugate> () { return true; }
+  template <> inline bool ConjugateBlockProduct<ComplexConjugate2> () { return true; }
+
+  // y = m x
+  template <class SCAL>
+  inline void ApplyBlock (const BaseMatrix & m, const MultiVector<SCAL> & x, MultiVector<SCAL> & y)
+  {
+    y = SCAL(0.0);
+    m.MultAdd (1.0, x, y);
+  }
+
+
+  /*
+    g = Trans(Conj(t)) t, or Trans(t) t for the bilinear form, 
+    with upper triangular t.
+    Rows belonging to (numerically) dependent vectors stay zero.
+  */
+  template <class SCAL>
+  static void BlockCholesky (FlatMatrix<SCAL> g, FlatMatrix<SCAL> t, bool conjugate)
+  {
+    int k = g.Height();
+    t = SCAL(0.0);
+    for (int i = 0; i < k; i++)
+      {
+	SCAL d = g(i,i);
+	for (int l = 0; l < i; l++)
+	  d -= ConjIf (t(l,i), conjugate) * t(l,i);
+
+	double size = conjugate ? std::real(d) : Abs(d);
+	if (size <= 1e-24 * Abs(g(i,i)) || size <= 0) continue;
+	t(i,i) = conjugate ? SCAL(sqrt (size)) : sqrt (d);
+
+	for (int j = i+1; j < k; j++)
+	  {
+	    SCAL sum = g(i,j);
+	    for (int l = 0; l < i; l++)
+	      sum -= ConjIf (t(l,i), conjugate) * t(l,j);
+	    t(i,j) = sum / ConjIf (t(i,i), conjugate);
+	  }
+      }
+  }
+
+  // solves g x = b in place, using the factor from BlockCholesky
+  template <class SCAL>
+  static void BlockCholeskySolve (FlatMatrix<SCAL> t, FlatMatrix<SCAL> b, bool conjugate)
+  {
+    int k = t.Height();
+    for (int i = 0; i < k; i++)
+      {
+	if (t(i,i) == SCAL(0.0)) { b.Row(i) = SCAL(0.0); continue; }
+	for (int l = 0; l < i; l++)
+	  b.Row(i) -= ConjIf (t(l,i), conjugate) * b.Row(l);
+	b.Row(i) *= SCAL(1.0) / ConjIf (t(i,i), conjugate);
+      }
+    for (int i = k-1; i >= 0; i--)
+      {
+	if (t(i,i) == SCAL(0.0)) continue;
+	for (int l = i+1; l < k; l++)
+	  b.Row(i) -= t(i,l) * b.Row(l);
+	b.Row(i) *= SCAL(1.0) / t(i,i);
+      }
+  }
+
+  /*
+    W = V T with orthonormal columns V and upper triangular T,
+    by Cholesky QR, done twice for stability.
+    Vectors dependent on the previous ones get a zero column in V
+    and a zero row in T.
+  */
+  template <class SCAL>
+  static void BlockQR (const MultiVector<SCAL> & w, MultiVector<SCAL> & v, FlatMatrix<SCAL> t)
+  {
+    int k = w.NumVectors();
+    Matrix<SCAL> g(k), ti(k), t1(k);
+
+    for (int pass = 0; pass < 2; pass++)
+      {
+	const MultiVector<SCAL> & x = (pass == 0) ? w : v;
+	x.InnerProduct (x, g, true);
+	BlockCholesky<SCAL> (g, t1, true);
+
+	// ti = inverse of t1, skipping the dependent vectors
+	ti = SCAL(0.0);
+	for (int j = 0; j < k; j++)
+	  for (int i = j; i >= 0; i--)
+	    {
+	      if (t1(i,i) == SCAL(0.0)) continue;
+	      SCAL sum = (i == j) ? SCAL(1.0) : SCAL(0.0);
+	      for (int l = i+1; l <= j; l++)
+		sum -= t1(i,l) * ti(l,j);
+	      ti(i,j) = sum / t1(i,i);
+	    }
+
+	MultiVector<SCAL> hv = x;
+	v = SCAL(0.0);
+	v.Add (hv, ti);
+
+	if (pass == 0)
+	  t = t1;
+	else
+	  {
+	    Matrix<SCAL> ht = t1 * t;
+	    t = ht;
+	  }
+      }
+  }
+
+
+
+  template <class IPTYPE>
+  void BlockCGSolver<IPTYPE> :: Mult (const BaseVector & f, BaseVector & u) const
+  {
+    MultiVector<SCAL> mf(f, 1), mu(f, 1);
+    mf.SetVector (0, f);
+    if (!initialize) mu.SetVector (0, u);
+    Mult (mf, mu);
+    mu.GetVector (0, u);
+  }
+
+  template <class IPTYPE>
+  void BlockCGSolver<IPTYPE> :: Mult (const MultiVector<SCAL> & f, MultiVector<SCAL> & u) const
+  {
+    static Timer timer ("Block CG solver");
+    RegionTimer reg (timer);
+
+    try
+      {
+	// Solve A U = F for all columns.
+	// The search directions P are orthonormalized in every step,
+	// which keeps Trans(P) A P regular for nearly dependent right hand sides
+	bool conj = ConjugateBlockProduct<IPTYPE>();
+	int k = f.NumVectors();
+	int n = f.Size(), es = f.EntrySize();
+
+	MultiVector<SCAL> r(n, es, k);
+	if (initialize)
+	  {
+	    u = SCAL(0.0);
+	    r = f;
+	  }
+	else
+	  {
+	    r = f;
+	    a->MultAdd (-1.0, u, r);
+	  }
+
+	MultiVector<SCAL> z = r;
+	if (c) ApplyBlock (*c, r, z);
+
+	// solution of the vectors still in the block
+	MultiVector<SCAL> ua = u;
+	auto p = make_shared<MultiVector<SCAL>> (n, es, k);
+	auto q = make_shared<MultiVector<SCAL>> (n, es, k);
+	Matrix<SCAL> tp(k), rz(k), pq(k), alpha(k), beta(k);
+	BlockQR (z, *p, tp);
+
+	z.InnerProduct (r, rz, conj);
+	Array<int> active(k);
+	Array<double> err(k);
+	double maxrz = 0;
+	for (int i = 0; i < k; i++)
+	  {
+	    active[i] = i;
+	    maxrz = max2 (maxrz, Abs (rz(i,i)));
+	    err[i] = stop_absolute ? prec * prec : prec * prec * Abs (rz(i,i));
+	  }
+
+	if (printrates) cout << IM(1) << "0 " << sqrt(maxrz) << endl;
+
+	int it = 0;
+	while (it++ < maxsteps && active.Size() && !(sh && sh->ShouldTerminate()))
+	  {
+	    int ka = active.Size();
+	    ApplyBlock (*a, *p, *q);
+
+	    // alpha = (Trans(P) A P)^-1 Trans(P) R
+	    p->InnerProduct (*q, pq, conj);
+	    p->InnerProduct (r, alpha, conj);
+	    BlockCholesky<SCAL> (pq, tp, conj);
+	    BlockCholeskySolve<SCAL> (tp, alpha, conj);
+
+	    ua.Add (*p, alpha);
+	    alpha *= -1.0;
+	    r.Add (*q, alpha);
+
+	    if (c) 
+	      ApplyBlock (*c, r, z);
+	    else
+	      z = r;
+
+	    z.InnerProduct (r, rz, conj);
+	    maxrz = 0;
+	    for (int i = 0; i < ka; i++)
+	      maxrz = max2 (maxrz, Abs (rz(i,i)));
+	    if (printrates) cout << IM(1) << it << " " << sqrt(maxrz) << " (" << ka << " vectors)" << endl;
+
+	    // remove converged vectors from the block
+	    Array<int> keep;
+	    for (int i = 0; i < ka; i++)
+	      if (Abs (rz(i,i)) > err[active[i]])
+		keep.Append (i);
+	      else
+		u.FM().Col(active[i]) = ua.FM().Col(i);
+
+	    int kk = keep.Size();
+	    if (kk == 0) { active.SetSize(0); break; }
+	    if (kk < ka)
+	      {
+		r.SelectVectors (keep);
+		z.SelectVectors (keep);
+		ua.SelectVectors (keep);
+		for (int i = 0; i < kk; i++)
+		  keep[i] = active[keep[i]];
+		active = keep;
+	      }
+
+	    // new directions  P = orth (Z + P beta),  A-orthogonal to the old P:
+	    // beta = -(Trans(P) A P)^-1 Trans(Q) Z
+	    beta.SetSize (p->NumVectors(), kk);
+	    q->InnerProduct (z, beta, conj);
+	    BlockCholeskySolve<SCAL> (tp, beta, conj);
+	    beta *= -1.0;
+
+	    MultiVector<SCAL> hp = z;
+	    hp.Add (*p, beta);
+	    if (kk < p->NumVectors())
+	      {
+		p = make_shared<MultiVector<SCAL>> (n, es, kk);
+		q = make_shared<MultiVector<SCAL>> (n, es, kk);
+		tp.SetSize (kk); rz.SetSize (kk); pq.SetSize (kk); 
+	      }
+	    alpha.SetSize (kk);
+	    BlockQR (hp, *p, tp);
+	  }
+
+	for (int i = 0; i < active.Size(); i++)
+	  u.FM().Col(active[i]) = ua.FM().Col(i);
+
+	((int&)steps) = it;
+      }
+
+    catch (exception & e)
+      {
+	throw Exception(e.what() +
+			string ("\ncaught in BlockCGSolver::Mult\n"));
+      }
+
+    catch (Exception & e)
+      {
+	e.Append ("in caught in BlockCGSolver::Mult\n"); 
+	throw;
+      }
+  }
+
+
+
+
+  // complex Givens rotation with  c a + s b = r,  - conj(s) a + c b = 0
+  inline void CalcGivens (double a, double b, double & c, double & s)
+  {
+    double r = sqrt (a*a+b*b);
+    if (r == 0) { c = 1; s = 0; return; }
+    c = a/r; s = b/r;
+  }
+
+  inline void CalcGivens (Complex a, Complex b, double & c, Complex & s)
+  {
+    double r = sqrt (sqr(Abs(a)) + sqr(Abs(b)));
+    if (r == 0) { c = 1; s = 0; return; }
+    if (Abs(a) == 0) { c = 0; s = conj(b) / r; return; }
+    c = Abs(a) / r;
+    s = (a / Abs(a)) * conj(b) / r;
+  }
+
+
+  template <class IPTYPE>
+  void BlockGMRESSolver<IPTYPE> :: Mult (const BaseVector & f, BaseVector & u) const
+  {
+    MultiVector<SCAL> mf(f, 1), mu(f, 1);
+    mf.SetVector (0, f);
+    if (!initialize) mu.SetVector (0, u);
+    Mult (mf, mu);
+    mu.GetVector (0, u);
+  }
+
+  template <class IPTYPE>
+  void BlockGMRESSolver<IPTYPE> :: Mult (const MultiVector<SCAL> & f, MultiVector<SCAL> & u) const
+  {
+    static Timer timer ("Block GMRES solver");
+    RegionTimer reg (timer);
+
+    try
+      {
+	// Solve A U = F, left preconditioned as GMRESSolver
+	int k = f.NumVectors();
+	int n = f.Size(), es = f.EntrySize();
+
+	MultiVector<SCAL> r(n, es, k), hv(n, es, k);
+	if (initialize)
+	  {
+	    u = SCAL(0.0);
+	    r = f;
+	  }
+	else
+	  {
+	    r = f;
+	    a->MultAdd (-1.0, u, r);
+	  }
+
+	if (c)
+	  {
+	    ApplyBlock (*c, r, hv);
+	    r = hv;
+	  }
+
+	// block Krylov basis, block columns of the Hessenberg matrix,
+	// with the rotations already applied
+	Array<shared_ptr<MultiVector<SCAL>>> vi;
+	Array<shared_ptr<Matrix<SCAL>>> hi;
+	Array<double> ci;
+	Array<SCAL> si;
+	Matrix<SCAL> g((maxsteps+1)*k, k);
+	g = SCAL(0.0);
+
+	vi.Append (make_shared<MultiVector<SCAL>> (n, es, k));
+	BlockQR (r, *vi[0], g.Rows(0,k));
+
+	Array<double> err(k);
+	double maxres = 0;
+	for (int l = 0; l < k; l++)
+	  {
+	    double norm = L2Norm (g.Col(l));
+	    maxres = max2 (maxres, norm);
+	    err[l] = stop_absolute ? prec : prec * norm;
+	  }
+
+	if (printrates) cout << IM(1) << "0 " << maxres << endl;
+
+	bool converged = (maxres == 0);
+	int j = 0;
+	for ( ; j < maxsteps && !converged && !(sh && sh->ShouldTerminate()); j++)
+	  {
+	    MultiVector<SCAL> & v = *vi[j];
+	    MultiVector<SCAL> w(n, es, k);
+	    ApplyBlock (*a, v, w);
+	    if (c)
+	      {
+		ApplyBlock (*c, w, hv);
+		w = hv;
+	      }
+
+	    hi.Append (make_shared<Matrix<SCAL>> ((j+2)*k, k));
+	    Matrix<SCAL> & h = *hi[j];
+
+	    // block modified Gram-Schmidt
+	    Matrix<SCAL> hij(k), mhij(k);
+	    for (int i = 0; i <= j; i++)
+	      {
+		vi[i]->InnerProduct (w, hij, true);
+		h.Rows(i*k, (i+1)*k) = hij;
+		mhij = -hij;
+		w.Add (*vi[i], mhij);
+	      }
+
+	    vi.Append (make_shared<MultiVector<SCAL>> (n, es, k));
+	    BlockQR (w, *vi[j+1], h.Rows((j+1)*k, (j+2)*k));
+
+	    // rotations zero the k entries below the diagonal
+	    for (int cj = 0; cj < k; cj++)
+	      {
+		int p = j*k+cj;
+		for (int q = 0; q < p; q++)
+		  for (int t = 1; t <= k; t++)
+		    {
+		      int ind = q*k+t-1;
+		      SCAL hq = h(q,cj), ht = h(q+t,cj);
+		      h(q,cj)   = ci[ind] * hq + si[ind] * ht;
+		      h(q+t,cj) = -Conj(si[ind]) * hq + ci[ind] * ht;
+		    }
+
+		for (int t = 1; t <= k; t++)
+		  {
+		    double cs; SCAL sn;
+		    CalcGivens (h(p,cj), h(p+t,cj), cs, sn);
+		    ci.Append (cs);
+		    si.Append (sn);
+
+		    SCAL hp = h(p,cj), ht = h(p+t,cj);
+		    h(p,cj)   = cs * hp + sn * ht;
+		    h(p+t,cj) = 0.0;
+
+		    for (int l = 0; l < k; l++)
+		      {
+			SCAL gp = g(p,l), gt = g(p+t,l);
+			g(p,l)   = cs * gp + sn * gt;
+			g(p+t,l) = -Conj(sn) * gp + cs * gt;
+		      }
+		  }
+	      }
+
+	    // residual norms of the least squares problems
+	    maxres = 0;
+	    converged = true;
+	    for (int l = 0; l < k; l++)
+	      {
+		double res = L2Norm (g.Col(l).Range((j+1)*k, (j+2)*k));
+		maxres = max2 (maxres, res);
+		if (res > err[l]) converged = false;
+	      }
+
+	    if (printrates) cout << IM(1) << j+1 << " " << maxres << endl;
+	  }
+
+	// back substitution, U += sum V_i Y_i
+	int dim = j*k;
+	Matrix<SCAL> y(dim, k);
+	for (int l = 0; l < k; l++)
+	  for (int i = dim-1; i >= 0; i--)
+	    {
+	      SCAL hii = (*hi[i/k])(i, i%k);
+	      if (hii == SCAL(0.0)) { y(i,l) = 0.0; continue; }
+
+	      SCAL sum = g(i,l);
+	      for (int m = i+1; m < dim; m++)
+		sum -= (*hi[m/k])(i, m%k) * y(m,l);
+	      y(i,l) = sum / hii;
+	    }
+
+	for (int i = 0; i < j; i++)
+	  u.Add (*vi[i], y.Rows(i*k, (i+1)*k));
+
+	((int&)steps) = j;
+      }
+
+    catch (exception & e)
+      {
+	throw Exception(e.what() +
+			string ("\ncaught in BlockGMRESSolver::Mult\n"));
+      }
+
+    catch (Exception & e)
+      {
+	e.Append ("in caught in BlockGMRESSolver::Mult\n"); 
+	throw;
+      }
+  }
+
+
+
   template class CGSolver<double>;
   template class CGSolver<Complex>;
   template class CGSolver<ComplexConjugate>;
@@ -1333,6 +1976,14 @@ void QMRSolver<SCAL> :: Mult (const BaseVector & b, BaseVector & x) const
   template class GMRESSolver<Complex>;
   template class GMRESSolver<ComplexConjugate>;
   template class GMRESSolver<ComplexConjugate2>;
+  template class BlockCGSolver<double>;
+  template class BlockCGSolver<Complex>;
+  template class BlockCGSolver<ComplexConjugate>;
+  template class BlockCGSolver<ComplexConjugate2>;
+  template class BlockGMRESSolver<double>;
+  template class BlockGMRESSolver<Complex>;
+  template class BlockGMRESSolver<ComplexConjugate>;
+  template class BlockGMRESSolver<ComplexConjugate2>;
 
 
 }
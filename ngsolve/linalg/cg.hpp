@@ -36,6 +36,8 @@ namespace ngla
     int absoluteRes;
     ///
     bool useseed;
+    /// CGSolver: pipelined variant
+    bool pipelined;
 
     ///
     const BaseStatusHandler * sh;
@@ -104,6 +106,8 @@ namespace ngla
     void MultiMult (const BaseVector & f, BaseVector & u, const int dim) const;
     ///
     void MultiMultSeed (const BaseVector & f, BaseVector & u, const int dim) const;
+    /// pipelined CG (Ghysels-Vanroose): one fused, non-blocking reduction per step
+    void MultPipelined (const BaseVector & f, BaseVector & u) const;
   public:
     typedef typename SCAL_TRAIT<IPTYPE>::SCAL SCAL;
     ///
@@ -117,6 +121,9 @@ namespace ngla
     CGSolver (const BaseMatrix & aa, const BaseMatrix & ac)
       : KrylovSpaceSolver (aa, ac) { ; }
 
+    /// overlap the inner products with preconditioner and matrix application
+    void SetPipelined (bool apipelined = true) { pipelined = apipelined; }
+
     ///
     NGS_DLL_HEADER virtual void Mult (const BaseVector & v, BaseVector & prod) const;
   };
@@ -198,6 +205,64 @@ namespace ngla
 
 
 
+  /**
+     Block conjugate gradient solver (O'Leary) for many right hand sides.
+     One matrix and preconditioner application per step for all vectors.
+     Converged vectors are removed from the block.
+  */
+  template <class IPTYPE>
+  class NGS_DLL_HEADER BlockCGSolver : public KrylovSpaceSolver
+  {
+  public:
+    typedef typename SCAL_TRAIT<IPTYPE>::SCAL SCAL;
+    ///
+    BlockCGSolver () 
+      : KrylovSpaceSolver () { ; }
+    ///
+    BlockCGSolver (const BaseMatrix & aa)
+      : KrylovSpaceSolver (aa) { ; }
+
+    ///
+    BlockCGSolver (const BaseMatrix & aa, const BaseMatrix & ac)
+      : KrylovSpaceSolver (aa, ac) { ; }
+
+    /// solves for all vectors of the block
+    void Mult (const MultiVector<SCAL> & f, MultiVector<SCAL> & u) const;
+    ///
+    virtual void Mult (const BaseVector & v, BaseVector & prod) const;
+  };
+
+
+
+  /**
+     Block GMRES solver for many right hand sides, 
+     without restart. The Krylov space is built block by block.
+  */
+  template <class IPTYPE>
+  class NGS_DLL_HEADER BlockGMRESSolver : public KrylovSpaceSolver
+  {
+  public:
+    typedef typename SCAL_TRAIT<IPTYPE>::SCAL SCAL;
+    ///
+    BlockGMRESSolver () 
+      : KrylovSpaceSolver () { ; }
+    ///
+    BlockGMRESSolver (const BaseMatrix & aa)
+      : KrylovSpaceSolver (aa) { ; }
+
+    ///
+    BlockGMRESSolver (const BaseMatrix & aa, const BaseMatrix & ac)
+      : KrylovSpaceSolver (aa, ac) { ; }
+
+    /// solves for all vectors of the block
+    void Mult (const MultiVector<SCAL> & f, MultiVector<SCAL> & u) const;
+    ///
+    virtual void Mult (const BaseVector & v, BaseVector & prod) const;
+  };
+
+
+
+
   /// The quasi-minimal residual (QMR) solver
   template <class IPTYPE>
   class NGS_DLL_HEADER QMRSolver : public KrylovSpaceSolver
@@ -32,6 +32,102 @@ namespace ngla
     for (int i = 0; i < height; i++)
       if (!inner || inner->Test(i))
 	CalcInverse (invdiag[i]);
+
+    if (omp_get_max_threads() > 1)
+      CalcColoring();
+  }
+
+
+  template <class TM, class TV_ROW, class TV_COL>
+  void JacobiPrecond<TM,TV_ROW,TV_COL> :: CalcColoring ()
+  {
+    static Timer t("JacobiPrecond::CalcColoring");
+    RegionTimer reg(t);
+
+    // For the symmetric storage a row also updates the entries of its 
+    // column indices (AddRowTransToVector), rows of one color must not 
+    // share a column. For the full storage, rows of one color must not couple.
+    bool symmetric = dynamic_cast<const SparseMatrixSymmetricTM<TM>*> (&mat) != NULL;
+
+    Array<int> color(height);
+    color = -1;
+
+    // greedy coloring, 64 colors per pass:
+    // bit c of mask[j] is set if a row of color base+c has column j
+    Array<unsigned long long> mask(mat.Width());
+    int ncolors = 0;
+    bool uncolored = true;
+    for (int base = 0; uncolored; base += 64)
+      {
+	uncolored = false;
+	mask = 0;
+	for (int i = 0; i < height; i++)
+	  {
+	    if (color[i] != -1 || (inner && !inner->Test(i))) continue;
+
+	    FlatArray<int> cols = mat.GetRowIndices(i);
+	    unsigned long long used = 0;
+	    if (symmetric)
+	      for (int j : cols)
+		used |= mask[j];
+	    else
+	      {
+		used = mask[i];
+		for (int j : cols)
+		  if (color[j] >= base)
+		    used |= 1ull << (color[j]-base);
+	      }
+
+	    if (used == ~0ull) 
+	      {
+		uncolored = true;
+		continue;
+	      }
+
+	    int c = 0;
+	    while (used & (1ull << c)) c++;
+	    color[i] = base+c;
+	    ncolors = max2 (ncolors, base+c+1);
+	    for (int j : cols)
+	      mask[j] |= 1ull << c;
+	  }
+      }
+
+    TableCreator<int> creator(ncolors);
+    for ( ; !creator.Done(); creator++)
+      for (int i = 0; i < height; i++)
+	if (color[i] != -1)
+	  creator.Add (color[i], i);
+    coloring = creator.MoveTable();
+
+
+    // calc balancing:
+    int max_threads = omp_get_max_threads();
+    balancing = Table<int> (coloring.Size(), max_threads+1);
+
+    Array<int> entrysizes(coloring.Size());
+    for (int c = 0; c < coloring.Size(); c++)
+      entrysizes[c] = coloring[c].Size();
+    Table<int> prefix(entrysizes);
+
+    for (int c = 0; c < coloring.Size(); c++)
+      {
+	FlatArray<int> rows = coloring[c];
+	FlatArray<int> c_pre = prefix[c];
+
+	size_t sum = 0;
+	for (int ii : Range(rows))
+	  {
+	    sum += mat.GetRowIndices(rows[ii]).Size();
+	    c_pre[ii] = sum;
+	  }
+
+	balancing[c][0] = 0;
+	for (int tid = 0; tid < max_threads; tid++)
+	  balancing[c][tid+1] = BinSearch (c_pre, size_t(c_pre[c_pre.Size()-1])*(tid+1)/max_threads);
+      }
+    
+    *testout << "JacobiPrecond: " << ncolors << " colors for parallel Gauss-Seidel" << endl;
   }
 
   ///
@@ -86,6 +182,26 @@ namespace ngla
     const FlatVector<TV_ROW> fb = b.FV<TV_ROW> ();
     // dynamic_cast<const T_BaseVector<TV_ROW> &> (b).FV();
 
+    if (UseColoring())
+      {
+#pragma omp parallel num_threads(balancing[0].Size()-1)
+	{
+	  int tid = omp_get_thread_num();
+	  for (int c = 0; c < coloring.Size(); c++)
+	    {
+	      FlatArray<int> rows = coloring[c];
+	      for (int ii : IntRange (balancing[c][tid], balancing[c][tid+1]))
+		{
+		  int i = rows[ii];
+		  TV_ROW ax = mat.RowTimesVector (i, fx);
+		  fx(i) += invdiag[i] * (fb(i) - ax);
+		}
+#pragma omp barrier
+	    }
+	}
+	return;
+      }
+
     for (int i = 0; i < height; i++)
       if (!this->inner || this->inner->Test(i))
 	{
@@ -108,6 +224,26 @@ namespace ngla
     const FlatVector<TV_ROW> fb = b.FV<TV_ROW> ();
       //dynamic_cast<const T_BaseVector<TV_ROW> &> (b).FV();
 
+    if (UseColoring())
+      {
+#pragma omp parallel num_threads(balancing[0].Size()-1)
+	{
+	  int tid = omp_get_thread_num();
+	  for (int c = coloring.Size()-1; c >= 0; c--)
+	    {
+	      FlatArray<int> rows = coloring[c];
+	      for (int ii = balancing[c][tid+1]-1; ii >= balancing[c][tid]; ii--)
+		{
+		  int i = rows[ii];
+		  TV_ROW ax = mat.RowTimesVector (i, fx);
+		  fx(i) += invdiag[i] * (fb(i) - ax);
+		}
+#pragma omp barrier
+	    }
+	}
+	return;
+      }
+
     for (int i = height-1; i >= 0; i--)
       if (!this->inner || this->inner->Test(i))
 	{
@@ -154,6 +290,12 @@ namespace ngla
     const SparseMatrixSymmetric<TM,TV> & smat =
       dynamic_cast<const SparseMatrixSymmetric<TM,TV>&> (this->mat);
 
+    if (this->UseColoring())
+      {
+	GSSmoothPartialColored (fx, PartialResidual (x, b), false);
+	return;
+      }
+
     // x := b - L^t x
     for (int i = 0; i < this->height; i++)
       if (!this->inner || this->inner->Test(i))
@@ -188,6 +330,12 @@ namespace ngla
     const SparseMatrixSymmetric<TM,TV> & smat =
       dynamic_cast<const SparseMatrixSymmetric<TM,TV>&> (this->mat);
 
+    if (this->UseColoring())
+      {
+	GSSmoothPartialColored (fx, fy, false);
+	return;
+      }
+
     // input, y = b - (D+L^t) x
     // (L+D) x_new := b - L^t x  = y + D x
     // D (x_new-x) = b - L x_new
@@ -225,6 +373,12 @@ namespace ngla
 
     const SparseMatrixSymmetric<TM,TV> & smat =
       dynamic_cast<const SparseMatrixSymmetric<TM,TV>&> (this->mat);
+
+    if (this->UseColoring())
+      {
+	GSSmoothPartialColored (fx, PartialResidual (x, b), true);
+	return;
+      }
     
     for (int i = this->height-1; i >= 0; i--)
       if (!this->inner || this->inner->Test(i))
@@ -246,6 +400,71 @@ namespace ngla
 	fx(i) = TVX(0);
   }
 
+
+  template <class TM, class TV>
+  FlatVector<typename JacobiPrecondSymmetric<TM,TV>::TVX> 
+  JacobiPrecondSymmetric<TM,TV> ::
+  PartialResidual (BaseVector & x, const BaseVector & b) const
+  {
+    const SparseMatrixSymmetric<TM,TV> & smat =
+      dynamic_cast<const SparseMatrixSymmetric<TM,TV>&> (this->mat);
+
+    FlatVector<TVX> fx = x.FV<TVX> ();
+    if (this->inner)
+      for (int i = 0; i < this->height; i++)
+	if (!this->inner->Test(i))
+	  fx(i) = TVX(0);
+
+    // only called outside of parallel regions, see UseColoring
+    if (!gs_residual)
+      gs_residual = make_shared<VVector<TVX>> (this->height);
+
+    VVector<TVX> & y = *gs_residual;
+    y = 1.0*b;
+    smat.MultAdd2 (-1, x, y);
+    return y.FV();
+  }
+
+
+  /*
+    The partial residual y = b - (D+L^T) x is kept up to date for every
+    processed row, so the rows can be visited in any order.
+  */
+  template <class TM, class TV>
+  void JacobiPrecondSymmetric<TM,TV> ::
+  GSSmoothPartialColored (FlatVector<TVX> fx, FlatVector<TVX> fy, bool backward) const
+  {
+    static Timer timer("JacobiPrecondSymmetric::GSSmooth - colored");
+    RegionTimer reg (timer);
+
+    const SparseMatrixSymmetric<TM,TV> & smat =
+      dynamic_cast<const SparseMatrixSymmetric<TM,TV>&> (this->mat);
+
+    const Table<int> & coloring = this->coloring;
+    const Table<int> & balancing = this->balancing;
+    int ncolors = coloring.Size();
+
+#pragma omp parallel num_threads(balancing[0].Size()-1)
+    {
+      int tid = omp_get_thread_num();
+      for (int cc = 0; cc < ncolors; cc++)
+	{
+	  int c = backward ? ncolors-1-cc : cc;
+	  FlatArray<int> rows = coloring[c];
+	  for (int ii : IntRange (balancing[c][tid], balancing[c][tid+1]))
+	    {
+	      int i = rows[ii];
+	      TVX d = fy(i) - smat.RowTimesVectorNoDiag (i, fx);
+	      TVX w = this->invdiag[i] * d;
+	      
+	      fx(i) += w;
+	      smat.AddRowTransToVector (i, -w, fy);
+	    }
+#pragma omp barrier
+	}
+    }
+  }
+
   ///
   template <class TM, class TV>
   void JacobiPrecondSymmetric<TM,TV> ::
@@ -36,6 +36,19 @@ namespace ngla
     int height;
     ///
     Array<TM> invdiag;
+    /// independent rows, for the parallel Gauss-Seidel sweeps
+    Table<int> coloring;
+    /// rows of color c for thread tid are coloring[c][balancing[c][tid] ... balancing[c][tid+1]]
+    Table<int> balancing;
+
+    ///
+    void CalcColoring ();
+    ///
+    bool UseColoring () const
+    {
+      return coloring.Size() && !omp_in_parallel() &&
+        balancing[0].Size() == omp_get_max_threads()+1;
+    }
   public:
     // typedef typename mat_traits<TM>::TV_ROW TVX;
     typedef typename mat_traits<TM>::TSCAL TSCAL;
@@ -107,6 +120,16 @@ namespace ngla
     virtual void GSSmoothNumbering (BaseVector & x, const BaseVector & b,
 				    const Array<int> & numbering, 
 				    int forward = 1) const;
+
+  protected:
+    /// work vector for the colored sweeps, allocated on first use
+    mutable shared_ptr<VVector<TVX>> gs_residual;
+
+    /// sweep over the colors, y is the partial residual b - (D+L^T) x
+    void GSSmoothPartialColored (FlatVector<TVX> fx, FlatVector<TVX> fy, 
+                                 bool backward) const;
+    /// x = 0 outside inner, and the partial residual b - (D+L^T) x in gs_residual
+    FlatVector<TVX> PartialResidual (BaseVector & x, const BaseVector & b) const;
   };
 
 }
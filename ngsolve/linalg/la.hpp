@@ -30,6 +30,7 @@ namespace ngla
 #include "paralleldofs.hpp"
 #include "basevector.hpp"
 #include "vvector.hpp"
+#include "multivector.hpp"
 #include "basematrix.hpp"
 #include "sparsematrix.hpp"
 #include "order.hpp"
@@ -40,12 +41,14 @@ namespace ngla
 #include "jacobi.hpp"
 #include "blockjacobi.hpp"
 #include "commutingAMG.hpp"
+#include "aggregationamg.hpp"
 #include "special_matrix.hpp"
 #include "elementbyelement.hpp"
 #include "cg.hpp"
 #include "chebyshev.hpp"
 #include "eigen.hpp"
 #include "arnoldi.hpp"
+#include "lobpcg.hpp"
 
 #include "cuda_linalg.hpp"
 
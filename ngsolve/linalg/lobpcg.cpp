@@ -0,0 +1,403 @@
+/**************************************************************************/
+/* File:   lobpcg.cpp                                                     */
+/* Date:   Oct. 2026                                                      */
+/**************************************************************************/
+
+/*
+
+LOBPCG Eigenvalue Solver
+
+*/
+
+#include <la.hpp>
+
+namespace ngla
+{
+
+  /// vectors V of the block, together with A V and M V (A V may be missing)
+  template <class SCAL>
+  struct LOBPCGBlock
+  {
+    shared_ptr<MultiVector<SCAL>> v, av, mv;
+    int Size() const { return v ? v->NumVectors() : 0; }
+  };
+
+
+  // y = mat x
+  template <class SCAL>
+  static void BlockMult (const BaseMatrix & mat, const MultiVector<SCAL> & x, MultiVector<SCAL> & y)
+  {
+    y = SCAL(0.0);
+    mat.MultAdd (1.0, x, y);
+  }
+
+  template <class SCAL>
+  static void ClearNonFree (MultiVector<SCAL> & v, const BitArray * freedofs)
+  {
+    if (!freedofs) return;
+    FlatMatrix<SCAL> fv = v.FM();
+    int es = v.EntrySize();
+    for (int i = 0; i < v.Size(); i++)
+      if (!freedofs->Test(i))
+        fv.Rows(i*es, (i+1)*es) = SCAL(0.0);
+  }
+
+  /*
+    Hermitian a c = lam b c by Lapack, lam ascending,
+    the eigenvectors in the columns of c.
+  */
+  template <class SCAL>
+  static int GeneralizedEVP (FlatMatrix<SCAL> a, FlatMatrix<SCAL> b,
+                             FlatVector<double> lam, FlatMatrix<SCAL> c)
+  {
+    int n = a.Height();
+    if (n == 0) return 0;
+#ifdef LAPACK
+    // Lapack is column major
+    Matrix<SCAL> ha = Trans(a), hb = Trans(b);
+    int info = LapackGHEPEPairs (n, &ha(0,0), &hb(0,0), &lam(0));
+    c = Trans(ha);
+    return info;
+#else
+    throw Exception ("LOBPCG not available without Lapack");
+#endif
+  }
+
+  // sum of blocks[i] * coefs.Rows(block i), for the blocks starting from first
+  template <class SCAL>
+  static LOBPCGBlock<SCAL> Combine (FlatArray<LOBPCGBlock<SCAL>> blocks,
+                                    FlatMatrix<SCAL> coefs, int first)
+  {
+    const MultiVector<SCAL> & proto = *blocks[0].v;
+    int k = coefs.Width();
+    LOBPCGBlock<SCAL> res;
+    res.v = make_shared<MultiVector<SCAL>> (proto.Size(), proto.EntrySize(), k);
+    if (blocks[0].av)
+      res.av = make_shared<MultiVector<SCAL>> (proto.Size(), proto.EntrySize(), k);
+    res.mv = make_shared<MultiVector<SCAL>> (proto.Size(), proto.EntrySize(), k);
+
+    int offset = 0;
+    for (int i = 0; i < blocks.Size(); i++)
+      {
+        int bs = blocks[i].Size();
+        if (i >= first)
+          {
+            Matrix<SCAL> bcoefs = coefs.Rows(offset, offset+bs);
+            res.v -> Add (*blocks[i].v, bcoefs);
+            if (blocks[i].av) res.av -> Add (*blocks[i].av, bcoefs);
+            res.mv -> Add (*blocks[i].mv, bcoefs);
+          }
+        offset += bs;
+      }
+    return res;
+  }
+
+  /*
+    M-orthonormal basis of the block by the eigen-decomposition of
+    the scaled Gram matrix. Dependent directions are dropped.
+  */
+  template <class SCAL>
+  static void Orthonormalize (LOBPCGBlock<SCAL> & b)
+  {
+    int k = b.Size();
+    if (k == 0) return;
+
+    Matrix<SCAL> g(k), id(k), q(k);
+    Vector<double> lam(k), d(k);
+    b.v -> InnerProduct (*b.mv, g, true);
+
+    for (int i = 0; i < k; i++)
+      d(i) = (abs (g(i,i)) > 0) ? 1.0 / sqrt (abs (g(i,i))) : 0.0;
+    for (int i = 0; i < k; i++)
+      for (int j = 0; j < k; j++)
+        g(i,j) *= d(i) * d(j);
+
+    id = SCAL(0.0);
+    for (int i = 0; i < k; i++)
+      id(i,i) = 1.0;
+    if (GeneralizedEVP<SCAL> (g, id, lam, q))
+      throw Exception ("LOBPCG: orthonormalization failed");
+
+    Array<int> keep;
+    for (int i = 0; i < k; i++)
+      if (lam(i) > 1e-12 * lam(k-1))
+        keep.Append (i);
+
+    Matrix<SCAL> coefs(k, keep.Size());
+    for (int j = 0; j < keep.Size(); j++)
+      for (int i = 0; i < k; i++)
+        coefs(i,j) = d(i) * q(i,keep[j]) / sqrt (lam(keep[j]));
+
+    LOBPCGBlock<SCAL> hb[] = { b };
+    b = Combine<SCAL> (FlatArray<LOBPCGBlock<SCAL>> (1, hb), coefs, 0);
+  }
+
+  // b -= c (c^H M b), c is M-orthonormal
+  template <class SCAL>
+  static void Project (LOBPCGBlock<SCAL> & b, const LOBPCGBlock<SCAL> & c)
+  {
+    if (!b.Size() || !c.Size()) return;
+    Matrix<SCAL> h(c.Size(), b.Size());
+    c.mv -> InnerProduct (*b.v, h, true);
+    h *= -1.0;
+    b.v -> Add (*c.v, h);
+    if (b.av) b.av -> Add (*c.av, h);
+    b.mv -> Add (*c.mv, h);
+  }
+
+  template <class SCAL>
+  static void SelectVectors (LOBPCGBlock<SCAL> & b, FlatArray<int> select)
+  {
+    b.v -> SelectVectors (select);
+    b.av -> SelectVectors (select);
+    b.mv -> SelectVectors (select);
+  }
+
+
+
+  template <typename SCAL>
+  int LOBPCG<SCAL> :: Calc (int nev, Array<double> & lam,
+                            Array<shared_ptr<BaseVector>> & evecs,
+                            const BaseMatrix * pre) const
+  {
+    static Timer t("LOBPCG");
+    static Timer tapply("LOBPCG - apply A and M");
+    static Timer tpre("LOBPCG - preconditioner");
+    static Timer trr("LOBPCG - Rayleigh-Ritz");
+    RegionTimer reg(t);
+
+    typedef MultiVector<SCAL> MV;
+
+    auto hv = a.CreateVector();
+    MV proto(hv, 0);
+    int n = proto.Size(), es = proto.EntrySize();
+    int nfree = es * (freedofs ? freedofs->NumSet() : n);
+
+    nev = min2 (nev, nfree);
+    int bs = blocksize ? max2 (blocksize, nev) : nev + nev/5 + 2;
+    bs = min2 (bs, nfree);
+
+    auto apply = [&] (LOBPCGBlock<SCAL> & b)
+      {
+        RegionTimer reg(tapply);
+        b.av = make_shared<MV> (n, es, b.Size());
+        b.mv = make_shared<MV> (n, es, b.Size());
+        BlockMult (a, *b.v, *b.av);
+        BlockMult (m, *b.v, *b.mv);
+      };
+
+    // random start vectors on the free dofs
+    LOBPCGBlock<SCAL> x, p;
+    x.v = make_shared<MV> (n, es, bs);
+    FlatMatrix<SCAL> fx = x.v->FM();
+    for (int i = 0; i < fx.Height(); i++)
+      for (int j = 0; j < fx.Width(); j++)
+        fx(i,j) = double (rand()) / RAND_MAX - 0.5;
+    ClearNonFree (*x.v, freedofs);
+    apply (x);
+    Orthonormalize (x);
+    if (x.Size() < nev)
+      throw Exception ("LOBPCG: start vectors are dependent");
+
+    // Rayleigh-Ritz on the span of the blocks [X, W, P]:
+    // the lowest Ritz vectors are the new X, their part outside of X is the new P
+    Vector<double> ritz;
+    auto rayleigh_ritz = [&] (FlatArray<LOBPCGBlock<SCAL>> blocks) -> int
+      {
+        RegionTimer reg(trr);
+        int ms = 0;
+        for (auto & b : blocks) ms += b.Size();
+
+        Matrix<SCAL> ga(ms), gm(ms), c(ms);
+        Vector<double> theta(ms);
+        for (int i = 0, oi = 0; i < blocks.Size(); oi += blocks[i].Size(), i++)
+          for (int j = 0, oj = 0; j < blocks.Size(); oj += blocks[j].Size(), j++)
+            {
+              Matrix<SCAL> h(blocks[i].Size(), blocks[j].Size());
+              blocks[i].v -> InnerProduct (*blocks[j].av, h, true);
+              ga.Rows(oi, oi+h.Height()).Cols(oj, oj+h.Width()) = h;
+              blocks[i].v -> InnerProduct (*blocks[j].mv, h, true);
+              gm.Rows(oi, oi+h.Height()).Cols(oj, oj+h.Width()) = h;
+            }
+
+        int info = GeneralizedEVP<SCAL> (ga, gm, theta, c);
+        if (info) return info;
+
+        int k = blocks[0].Size();
+        Matrix<SCAL> ck = c.Cols(0, k);
+        if (blocks.Size() > 1)
+          p = Combine (blocks, ck, 1);
+        x = Combine (blocks, ck, 0);
+        ritz.SetSize (k);
+        ritz = theta.Range(0, k);
+        return 0;
+      };
+
+    {
+      LOBPCGBlock<SCAL> blocks[] = { x };
+      if (rayleigh_ritz (FlatArray<LOBPCGBlock<SCAL>> (1, blocks)))
+        throw Exception ("LOBPCG: Rayleigh-Ritz for the start vectors failed");
+    }
+
+    // converged pairs, together with A and M times the vectors
+    LOBPCGBlock<SCAL> locked;
+    locked.v = make_shared<MV> (n, es, nev);
+    locked.av = make_shared<MV> (n, es, nev);
+    locked.mv = make_shared<MV> (n, es, nev);
+    int nlocked = 0, restarts = 0;
+    lam.SetSize (0);
+
+    int it;
+    for (it = 1; it <= maxsteps; it++)
+      {
+        int k = x.Size();
+
+        // residuals  R = A X - M X diag(ritz)
+        MV r = *x.av;
+        Matrix<SCAL> dlam(k);
+        dlam = SCAL(0.0);
+        for (int j = 0; j < k; j++)
+          dlam(j,j) = -ritz(j);
+        r.Add (*x.mv, dlam);
+        ClearNonFree (r, freedofs);
+
+        Matrix<SCAL> rr(k), mm(k);
+        r.InnerProduct (r, rr, true);
+        x.mv -> InnerProduct (*x.mv, mm, true);
+        Array<double> res(k);
+        for (int j = 0; j < k; j++)
+          {
+            double scale = fabs (ritz(j)) * sqrt (abs (mm(j,j)));
+            res[j] = sqrt (abs (rr(j,j))) / ((scale > 0) ? scale : 1);
+          }
+
+        // lock the lowest pairs as long as they are converged
+        int nconv = 0;
+        while (nlocked+nconv < nev && res[nconv] < prec) nconv++;
+
+        if (printrates)
+          {
+            double maxres = 0;
+            for (int j = nconv; j < nev-nlocked; j++)
+              maxres = max2 (maxres, res[j]);
+            cout << IM(1) << it << " " << maxres << " (" << nlocked+nconv << " locked)" << endl;
+          }
+
+        for (int j = 0; j < nconv; j++)
+          {
+            locked.v->FM().Col(nlocked+j) = x.v->FM().Col(j);
+            locked.av->FM().Col(nlocked+j) = x.av->FM().Col(j);
+            locked.mv->FM().Col(nlocked+j) = x.mv->FM().Col(j);
+            lam.Append (ritz(j));
+          }
+        nlocked += nconv;
+        if (nlocked == nev) break;
+
+        if (nconv)
+          {
+            Array<int> keep;
+            for (int j = nconv; j < k; j++)
+              keep.Append (j);
+            SelectVectors (x, keep);
+            if (p.Size()) SelectVectors (p, keep);
+            r.SelectVectors (keep);
+            Vector<double> hritz = ritz.Range(nconv, k);
+            k -= nconv;
+            ritz.SetSize (k);
+            ritz = hritz;
+          }
+
+        // preconditioned residuals
+        LOBPCGBlock<SCAL> w;
+        w.v = make_shared<MV> (n, es, k);
+        if (pre)
+          {
+            RegionTimer reg(tpre);
+            BlockMult (*pre, r, *w.v);
+          }
+        else
+          *w.v = r;
+        ClearNonFree (*w.v, freedofs);
+
+        // X, W and P M-orthogonal to the locked vectors, otherwise the
+        // Rayleigh-Ritz step finds the locked pairs again
+        if (nlocked)
+          {
+            Project (x, locked);
+            Orthonormalize (x);
+          }
+
+        // [X, W, P] M-orthonormal, twice for stability.  A and M are
+        // applied to the orthonormalized W and P, updating A P and M P
+        // by the scaled combinations accumulates the rounding errors
+        {
+          RegionTimer reg(tapply);
+          w.mv = make_shared<MV> (n, es, k);
+          BlockMult (m, *w.v, *w.mv);
+        }
+        for (int pass = 0; pass < 2; pass++)
+          {
+            Project (w, locked);
+            Project (w, x);
+            Orthonormalize (w);
+          }
+        apply (w);
+        p.av = nullptr;
+        for (int pass = 0; pass < 2; pass++)
+          {
+            Project (p, locked);
+            Project (p, x);
+            Project (p, w);
+            Orthonormalize (p);
+          }
+        if (p.Size()) apply (p);
+
+        Array<LOBPCGBlock<SCAL>> blocks;
+        blocks.Append (x);
+        if (w.Size()) blocks.Append (w);
+        if (p.Size()) blocks.Append (p);
+
+        int info = rayleigh_ritz (blocks);
+        if (info && p.Size())
+          {
+            // soft restart without the search directions
+            restarts++;
+            blocks.SetSize (w.Size() ? 2 : 1);
+            info = rayleigh_ritz (blocks);
+          }
+        if (info)
+          throw Exception ("LOBPCG: Rayleigh-Ritz failed, Lapack info = " + to_string(info));
+      }
+
+    int nconverged = nlocked;
+    // not converged: the best approximations
+    for (int j = 0; nlocked < nev; j++, nlocked++)
+      {
+        locked.v->FM().Col(nlocked) = x.v->FM().Col(j);
+        lam.Append (ritz(j));
+      }
+
+    cout << IM(1) << "LOBPCG: " << nconverged << " of " << nev << " eigenpairs converged in "
+         << min2 (it, maxsteps) << " steps, " << restarts << " restarts" << endl;
+
+    Array<int> index(nev);
+    for (int i = 0; i < nev; i++)
+      index[i] = i;
+    QuickSortI (lam, index);
+
+    Array<double> hlam(lam);
+    evecs.SetSize (nev);
+    for (int i = 0; i < nev; i++)
+      {
+        lam[i] = hlam[index[i]];
+        evecs[i] = a.CreateVector();
+        locked.v->GetVector (index[i], *evecs[i]);
+      }
+
+    return min2 (it, maxsteps);
+  }
+
+
+  template class LOBPCG<double>;
+  template class LOBPCG<Complex>;
+}
@@ -0,0 +1,65 @@
+#ifndef FILE_LOBPCG
+#define FILE_LOBPCG
+
+
+/**************************************************************************/
+/* File:   lobpcg.hpp                                                     */
+/* Date:   Oct. 2026                                                      */
+/**************************************************************************/
+
+namespace ngla
+{
+  /**
+     LOBPCG Eigenvalue Solver (Knyazev).
+
+     Computes the smallest eigenvalues of the generalized evp
+
+     A x = lam M x
+
+     A and M must be symmetric (hermitian), M positive definite.
+     The preconditioner approximates A^-1, no factorization is needed.
+
+     The block [X, W, P] of iterates, preconditioned residuals and
+     search directions is treated by MultiVector operations, the
+     Rayleigh-Ritz problem is solved by Lapack. Converged pairs are
+     locked and removed from the block, X, W and P are kept
+     M-orthogonal to them. If the Rayleigh-Ritz problem becomes
+     singular, the search directions P are dropped (soft restart).
+   */
+
+  template <typename SCAL>
+  class NGS_DLL_HEADER LOBPCG
+  {
+    const BaseMatrix & a;
+    const BaseMatrix & m;
+    const BitArray * freedofs;
+    double prec;
+    int maxsteps;
+    /// number of iterated vectors, 0 for nev + nev/5 + 2
+    int blocksize;
+    bool printrates;
+
+  public:
+    LOBPCG (const BaseMatrix & aa, const BaseMatrix & am, const BitArray * afreedofs = NULL)
+      : a(aa), m(am), freedofs(afreedofs)
+    {
+      prec = 1e-8;
+      maxsteps = 1000;
+      blocksize = 0;
+      printrates = false;
+    }
+
+    /// relative residual  |A x - lam M x| / |lam M x|  for locking a pair
+    void SetPrecision (double aprec) { prec = aprec; }
+    void SetMaxSteps (int amaxsteps) { maxsteps = amaxsteps; }
+    void SetBlockSize (int ablocksize) { blocksize = ablocksize; }
+    void SetPrintRates (bool pr = true) { printrates = pr; }
+
+    /// smallest nev eigenpairs, M-orthonormal eigenvectors. Returns the number of steps
+    int Calc (int nev, Array<double> & lam,
+              Array<shared_ptr<BaseVector>> & evecs,
+              const BaseMatrix * pre = NULL) const;
+  };
+}
+
+#endif
@@ -0,0 +1,166 @@
+/**************************************************************************/
+/* File:   multivector.cpp                                                */
+/* Date:   Oct. 2026                                                      */
+/**************************************************************************/
+
+/*
+   block of vectors, stored dof by dof
+*/
+
+#define FILE_MULTIVECTOR_CPP
+
+#include <la.hpp>
+
+namespace ngla
+{
+
+  // shorter blocks are not worth a parallel region
+  static const int multivector_parallel_size = 5000;
+
+
+  template <class SCAL>
+  MultiVector<SCAL> :: MultiVector (int asize, int aentrysize, int num)
+    : size(asize), entrysize(aentrysize), data(asize*aentrysize, num)
+  {
+    data = SCAL(0.0);
+  }
+
+  template <class SCAL>
+  MultiVector<SCAL> :: MultiVector (const BaseVector & v, int num)
+    : size(v.Size()), entrysize(v.EntrySize()*sizeof(double)/sizeof(SCAL)),
+      data(size*entrysize, num)
+  {
+    data = SCAL(0.0);
+  }
+
+  template <class SCAL>
+  MultiVector<SCAL> & MultiVector<SCAL> :: operator= (const MultiVector & v2)
+  {
+    if (data.Height() != v2.data.Height() || data.Width() != v2.data.Width())
+      throw Exception ("MultiVector::operator=: sizes do not match");
+    data = v2.data;
+    return *this;
+  }
+
+  template <class SCAL>
+  void MultiVector<SCAL> :: SetVector (int i, const BaseVector & v)
+  {
+    data.Col(i) = v.FV<SCAL>();
+  }
+
+  template <class SCAL>
+  void MultiVector<SCAL> :: GetVector (int i, BaseVector & v) const
+  {
+    v.FV<SCAL>() = data.Col(i);
+  }
+
+  template <class SCAL>
+  AutoVector MultiVector<SCAL> :: CreateVector () const
+  {
+    return S_BaseVectorPtr<SCAL> (size, entrysize, NULL).CreateVector();
+  }
+
+  template <class SCAL>
+  void MultiVector<SCAL> :: SelectVectors (FlatArray<int> select)
+  {
+    Matrix<SCAL> hdata(data.Height(), select.Size());
+    for (int j = 0; j < select.Size(); j++)
+      hdata.Col(j) = data.Col(select[j]);
+    data.SetSize (hdata.Height(), hdata.Width());
+    data = hdata;
+  }
+
+  template <class SCAL>
+  void MultiVector<SCAL> :: Add (const MultiVector & x, FlatMatrix<SCAL> coefs)
+  {
+    static Timer t("MultiVector::Add");
+    RegionTimer reg(t);
+
+    FlatMatrix<SCAL> fx = x.data, fy = data;
+    int n = fy.Height(), kx = fx.Width(), ky = fy.Width();
+
+#pragma omp parallel for if (n > multivector_parallel_size)
+    for (int i = 0; i < n; i++)
+      {
+        const SCAL * px = &fx(i,0);
+        SCAL * py = &fy(i,0);
+        for (int l = 0; l < kx; l++)
+          for (int j = 0; j < ky; j++)
+            py[j] += px[l] * coefs(l,j);
+      }
+  }
+
+  template <class SCAL>
+  void MultiVector<SCAL> :: ScaleAdd (FlatMatrix<SCAL> coefs, const MultiVector & x)
+  {
+    static Timer t("MultiVector::ScaleAdd");
+    RegionTimer reg(t);
+
+    FlatMatrix<SCAL> fx = x.data, fy = data;
+    int n = fy.Height(), k = fy.Width();
+
+#pragma omp parallel if (n > multivector_parallel_size)
+    {
+      ArrayMem<SCAL,32> hrow(k);
+#pragma omp for
+      for (int i = 0; i < n; i++)
+        {
+          SCAL * py = &fy(i,0);
+          const SCAL * px = &fx(i,0);
+          for (int j = 0; j < k; j++)
+            {
+              SCAL sum = px[j];
+              for (int l = 0; l < k; l++)
+                sum += py[l] * coefs(l,j);
+              hrow[j] = sum;
+            }
+          for (int j = 0; j < k; j++)
+            py[j] = hrow[j];
+        }
+    }
+  }
+
+  template <class SCAL>
+  void MultiVector<SCAL> :: InnerProduct (const MultiVector & y, FlatMatrix<SCAL> res,
+                                          bool conjugate) const
+  {
+    static Timer t("MultiVector::InnerProduct");
+    RegionTimer reg(t);
+
+    FlatMatrix<SCAL> fx = data, fy = y.data;
+    int n = fx.Height(), kx = fx.Width(), ky = fy.Width();
+
+    auto partial_product = [=] (IntRange r, FlatMatrix<SCAL> sum)
+      {
+        sum = SCAL(0.0);
+        for (int i : r)
+          {
+            const SCAL * px = &fx(i,0);
+            const SCAL * py = &fy(i,0);
+            for (int l = 0; l < kx; l++)
+              {
+                SCAL xl = ConjIf (px[l], conjugate);
+                for (int j = 0; j < ky; j++)
+                  sum(l,j) += xl * py[j];
+              }
+          }
+      };
+
+    // partial sums are added in thread order, independent of scheduling
+    int nt = omp_get_max_threads();
+    Matrix<SCAL> partial(nt*kx, ky);
+    partial = SCAL(0.0);
+    ParallelVectorLoop (n, multivector_parallel_size, [&] (IntRange r, int tid)
+                        {
+                          partial_product (r, partial.Rows(tid*kx, (tid+1)*kx));
+                        });
+
+    res = SCAL(0.0);
+    for (int tid = 0; tid < nt; tid++)
+      res += partial.Rows(tid*kx, (tid+1)*kx);
+  }
+
+
+  template class MultiVector<double>;
+  template class MultiVector<Complex>;
+}
@@ -0,0 +1,73 @@
+#ifndef FILE_MULTIVECTOR
+#define FILE_MULTIVECTOR
+
+/**************************************************************************/
+/* File:   multivector.hpp                                                */
+/* Date:   Oct. 2026                                                      */
+/**************************************************************************/
+
+namespace ngla
+{
+
+  /**
+     A block of vectors of the same size.
+
+     Stored dof by dof: the values of all vectors belonging to one dof
+     are contiguous, so a sparse matrix streams its entries only once
+     for all vectors. Not for parallel (MPI) vectors.
+  */
+  template <class SCAL>
+  class NGS_DLL_HEADER MultiVector
+  {
+    /// number of dofs
+    int size;
+    /// scalars per dof
+    int entrysize;
+    /// (size*entrysize) x number of vectors
+    Matrix<SCAL> data;
+
+  public:
+    ///
+    MultiVector (int asize, int aentrysize, int num);
+    /// num vectors like v
+    MultiVector (const BaseVector & v, int num);
+
+    int Size() const { return size; }
+    int EntrySize() const { return entrysize; }
+    int NumVectors() const { return data.Width(); }
+
+    /// one row per scalar of a vector, one column per vector
+    FlatMatrix<SCAL> FM() const { return data; }
+
+    MultiVector & operator= (const MultiVector & v2);
+    MultiVector & operator= (SCAL s) { data = s; return *this; }
+
+    /// vector i = v
+    void SetVector (int i, const BaseVector & v);
+    /// v = vector i
+    void GetVector (int i, BaseVector & v) const;
+
+    /// a single vector of matching size
+    AutoVector CreateVector () const;
+
+    /// keep only the selected vectors
+    void SelectVectors (FlatArray<int> select);
+
+    /// this += x * coefs,  coefs is x.NumVectors() x NumVectors()
+    void Add (const MultiVector & x, FlatMatrix<SCAL> coefs);
+    /// this = this * coefs + x
+    void ScaleAdd (FlatMatrix<SCAL> coefs, const MultiVector & x);
+
+    /// res = Trans(this) * y, or Trans(Conj(this)) * y
+    void InnerProduct (const MultiVector & y, FlatMatrix<SCAL> res,
+                       bool conjugate = false) const;
+  };
+
+#if not defined(FILE_MULTIVECTOR_CPP)
+  extern template class MultiVector<double>;
+  extern template class MultiVector<Complex>;
+#endif
+
+}
+
+#endif
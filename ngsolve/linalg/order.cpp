@@ -750,6 +750,12 @@ namespace ngla
 
 
   void MinimumDegreeOrdering :: Order()
+  {
+    Order (FlatArray<int> (0, nullptr));
+  }
+
+
+  void MinimumDegreeOrdering :: Order (FlatArray<int> prescribed)
   {
     static Timer reorder_timer("MinimumDegreeOrdering::Order");
     RegionTimer reg(reorder_timer);
@@ -765,6 +771,7 @@ namespace ngla
 
     int minj = -1;
     int lastel = -1;
+    int nextpre = 0;
 
     if (n > 5000)
       cout << IM(4) << "order " << flush;
@@ -794,6 +801,22 @@ namespace ngla
 	    EliminateSlaveVertex (minj);
 	  }
 
+	else if (prescribed.Size())
+	  {
+	    // next master in prescribed order, slaves go with their master
+	    while (nextpre < prescribed.Size() &&
+		   (vertices[prescribed[nextpre]].Eliminated() || 
+		    !IsMaster (prescribed[nextpre])))
+	      nextpre++;
+	    if (nextpre == prescribed.Size())
+	      throw Exception ("MinimumDegreeOrdering: prescribed order does not contain all vertices");
+	    minj = prescribed[nextpre];
+	    priqueue.Invalidate(minj);
+
+	    blocknr[i] = i;
+	    EliminateMasterVertex (minj);
+	  }
+
 	else
 	  {
 	    // find new master vertex
@@ -820,6 +843,19 @@ namespace ngla
 
 
 
+  Table<int> MinimumDegreeOrdering :: GetGraph () const
+  {
+    TableCreator<int> creator(n);
+    for ( ; !creator.Done(); creator++)
+      for (int i = 0; i < n; i++)
+	for (CliqueEl * p1 = cliques[i]; p1; p1 = p1->nextcl)
+	  for (CliqueEl * p2 = p1->next; p2 != p1; p2 = p2->next)
+	    creator.Add (i, p2->GetVertexNr());
+    return creator.MoveTable();
+  }
+
+
+
   MinimumDegreeOrdering:: ~MinimumDegreeOrdering ()
   {
     for (int i = 0; i < vertices.Size(); i++)
@@ -939,6 +975,162 @@ namespace ngla
 
 
 
+  /*
+    recursive bisection of the vertices verts, all having the 
+    domain number dom. Parts get new domain numbers, the separator 
+    is numbered last.
+  */
+  static void NestedDissectionRec (const Table<int> & graph, 
+				   FlatArray<int> verts, int dom,
+				   Array<int> & domain, int & ndomains,
+				   Array<int> & level, 
+				   Array<int> & order, int leafsize)
+  {
+    if (verts.Size() <= leafsize)
+      {
+	for (int v : verts)
+	  order.Append (v);
+	return;
+      }
+
+    // breadth first search, restricted to the domain
+    Array<int> queue(verts.Size());
+    auto bfs = [&] (int start)
+      {
+	for (int v : verts) level[v] = -1;
+	queue.SetSize(0);
+	queue.Append (start);
+	level[start] = 0;
+	for (int j = 0; j < queue.Size(); j++)
+	  {
+	    int v = queue[j];
+	    for (int w : graph[v])
+	      if (domain[w] == dom && level[w] == -1)
+		{
+		  level[w] = level[v]+1;
+		  queue.Append (w);
+		}
+	  }
+      };
+
+    // pseudo-peripheral start vertex
+    int start = verts[0];
+    bfs (start);
+    for (int iter = 0; iter < 3 && queue.Size() == verts.Size(); iter++)
+      {
+	int last = queue.Last();
+	if (level[last] <= level[queue[0]]) break;
+	int depth = level[last];
+	bfs (last);
+	if (level[queue.Last()] <= depth) break;
+      }
+
+    if (queue.Size() < verts.Size())
+      {
+	// not connected: all components in one pass. Small ones, as
+	// isolated (Dirichlet) dofs, are numbered directly, the others
+	// are dissected as new domains
+	for (int v : verts) level[v] = -1;
+	Array<int> compverts, firstcomp;
+	for (int v0 : verts)
+	  {
+	    if (level[v0] != -1) continue;
+	    queue.SetSize(0);
+	    queue.Append (v0);
+	    level[v0] = 0;
+	    for (int j = 0; j < queue.Size(); j++)
+	      for (int w : graph[queue[j]])
+		if (domain[w] == dom && level[w] == -1)
+		  {
+		    level[w] = 0;
+		    queue.Append (w);
+		  }
+
+	    if (queue.Size() <= leafsize)
+	      order.Append (queue);
+	    else
+	      {
+		firstcomp.Append (compverts.Size());
+		compverts.Append (queue);
+	      }
+	  }
+	firstcomp.Append (compverts.Size());
+
+	for (int i = 0; i+1 < firstcomp.Size(); i++)
+	  {
+	    FlatArray<int> comp = compverts.Range (firstcomp[i], firstcomp[i+1]);
+	    int domc = ndomains++;
+	    for (int v : comp) domain[v] = domc;
+	    NestedDissectionRec (graph, comp, domc, domain, ndomains, level, order, leafsize);
+	  }
+	return;
+      }
+
+    int nlevels = level[queue.Last()]+1;
+    int sepl = level[queue[queue.Size()/2]];
+    if (sepl == 0) sepl = 1;
+    if (sepl >= nlevels-1)
+      {
+	// no separator with two non-empty parts
+	for (int v : verts)
+	  order.Append (v);
+	return;
+      }
+
+    // separator are vertices of level sepl connected to level sepl+1
+    int doma = ndomains++;
+    int domb = ndomains++;
+    int doms = ndomains++;
+    Array<int> parta, partb, sep;
+    for (int v : queue)
+      {
+	if (level[v] < sepl)
+	  parta.Append (v);
+	else if (level[v] > sepl)
+	  partb.Append (v);
+	else
+	  {
+	    bool issep = false;
+	    for (int w : graph[v])
+	      if (domain[w] == dom && level[w] == sepl+1)
+		issep = true;
+	    if (issep)
+	      sep.Append (v);
+	    else
+	      parta.Append (v);
+	  }
+      }
+
+    for (int v : parta) domain[v] = doma;
+    for (int v : partb) domain[v] = domb;
+    for (int v : sep) domain[v] = doms;
+
+    NestedDissectionRec (graph, parta, doma, domain, ndomains, level, order, leafsize);
+    NestedDissectionRec (graph, partb, domb, domain, ndomains, level, order, leafsize);
+    for (int v : sep)
+      order.Append (v);
+  }
+
+
+  void NestedDissection (const Table<int> & graph, Array<int> & order, int leafsize)
+  {
+    static Timer t("NestedDissection");
+    RegionTimer reg(t);
+
+    int n = graph.Size();
+    Array<int> domain(n), level(n), verts(n);
+    domain = 0;
+    for (int i = 0; i < n; i++)
+      verts[i] = i;
+
+    order.SetSize(0);
+    int ndomains = 1;
+    NestedDissectionRec (graph, verts, 0, domain, ndomains, level, order, leafsize);
+  }
+
+
+
+
   MDOPriorityQueue :: MDOPriorityQueue (int size, int maxdeg)
     : list(size), first_in_class(maxdeg)
   {
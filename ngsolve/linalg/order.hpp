@@ -182,9 +182,14 @@ namespace ngla
     void EliminateSlaveVertex (int v);
     ///
     void Order();
+    /// eliminate in prescribed order, detect supernodes as in Order
+    void Order (FlatArray<int> prescribed);
     /// 
     ~MinimumDegreeOrdering();
 
+    /// the graph of edges added so far (before ordering)
+    Table<int> GetGraph () const;
+
     ///
     int NumCliques (int v) const;
 
@@ -232,6 +237,18 @@ namespace ngla
   };
 
 
+
+  /**
+     Nested dissection ordering of a graph.
+     The graph is recursively split by level-set separators, started from
+     pseudo-peripheral vertices. Both parts are numbered before their
+     separator, parts not larger than leafsize are not split.
+  */
+  extern NGS_DLL_HEADER void NestedDissection (const Table<int> & graph, 
+                                               Array<int> & order,
+                                               int leafsize = 64);
+
+
 }
 
 #endif
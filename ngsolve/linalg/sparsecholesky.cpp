@@ -27,12 +27,16 @@ namespace ngla
   SparseCholesky (const SparseMatrix<TM, TV_ROW, TV_COL> & a, 
 		  const BitArray * ainner,
 		  const Array<int> * acluster,
-		  bool allow_refactor)
-    : SparseFactorization (a, ainner, acluster), mat(a)
+		  bool allow_refactor,
+		  bool anested_dissection)
+    : SparseFactorization (a, ainner, acluster), 
+      nested_dissection(anested_dissection), mat(a)
   { 
     static Timer t("SparseCholesky - total");
     static Timer ta("SparseCholesky - allocate");
     static Timer tf("SparseCholesky - fill factor");
+    static Timer tfactmd("SparseCholesky - factor, MD ordering");
+    static Timer tfactnd("SparseCholesky - factor, ND ordering");
     RegionTimer reg(t);
     // (*testout) << "matrix = " << a << endl;
     // (*testout) << "diag a = ";
@@ -95,7 +99,14 @@ namespace ngla
       cout << IM(4) << "start ordering" << endl;
     
     // mdo -> PrintCliques ();
-    mdo->Order();
+    if (nested_dissection)
+      {
+        Array<int> ndorder;
+        NestedDissection (mdo->GetGraph(), ndorder);
+        mdo->Order (ndorder);
+      }
+    else
+      mdo->Order();
     
     endtime = clock();
     if (printstat)
@@ -178,11 +189,20 @@ namespace ngla
       cout << IM(4) << "do factor " << flush;
     
     
-    auto aspd = dynamic_cast<const SparseMatrixSymmetricTM<double>*> (&a);
-    if (aspd && aspd -> IsSPD())
-      FactorSPD();
-    else
-      Factor(); 
+    {
+      Timer & tfact = nested_dissection ? tfactnd : tfactmd;
+      RegionTimer regfact(tfact);
+      double flops = 0;
+      for (int i = 0; i < n; i++)
+        flops += sqr (double (firstinrow[i+1]-firstinrow[i]));
+      tfact.AddFlops (flops);
+
+      auto aspd = dynamic_cast<const SparseMatrixSymmetricTM<double>*> (&a);
+      if (aspd && aspd -> IsSPD())
+        FactorSPD();
+      else
+        Factor(); 
+    }
 
 
 
@@ -291,8 +311,57 @@ namespace ngla
       }
     firstinrow[n] = cnt;
     firstinrow_ri[n] = cnt_master;
+
+    CalcEliminationTree();
   }
-  
+
+
+
+  template <class TM, class TV_ROW, class TV_COL>
+  void SparseCholesky<TM, TV_ROW, TV_COL> :: CalcEliminationTree ()
+  {
+    static Timer t("SparseCholesky - elimination tree");
+    RegionTimer reg(t);
+
+    int n = height;
+
+    supernodes.SetSize(0);
+    Array<int> row2supernode(n);
+    for (int i = 0; i < n; i++)
+      {
+        if (blocknrs[i] == i)
+          supernodes.Append (i);
+        row2supernode[i] = supernodes.Size()-1;
+      }
+    int nsn = supernodes.Size();
+    supernodes.Append (n);
+
+    // the parent is the supernode of the first row outside the supernode,
+    // all updates of a supernode go to its ancestors
+    Array<int> level(nsn);
+    level = 0;
+    int maxlevel = 0;
+    for (int s = 0; s < nsn; s++)
+      {
+        int first = supernodes[s];
+        int next = supernodes[s+1];
+        int nk = firstinrow[first+1]-firstinrow[first];
+        maxlevel = max2 (maxlevel, level[s]);
+
+        if (next-first-1 < nk)
+          {
+            int parent = row2supernode[rowindex2[firstinrow_ri[first]+next-first-1]];
+            level[parent] = max2 (level[parent], level[s]+1);
+          }
+      }
+
+    TableCreator<int> creator(nsn ? maxlevel+1 : 0);
+    for ( ; !creator.Done(); creator++)
+      for (int s = 0; s < nsn; s++)
+        creator.Add (level[s], s);
+    supernode_levels = creator.MoveTable();
+  }
+
 
 
 
@@ -517,11 +586,12 @@ namespace ngla
         miBS = (mi / BS) * BS;
 
 
-	// #pragma omp parallel
+        // blocks of rows j write to different rows of the factor
+#pragma omp parallel if (miBS > 100)
         {
           Array<TM> sum(BS*maxrow);
           
-	  // #pragma omp for
+#pragma omp for schedule(dynamic) reduction(+:flops2)
           for (int j = 0; j < miBS; j+=BS)
             {
               for (int k = BS*(j+1); k < BS*mi; k++)
@@ -689,7 +759,6 @@ namespace ngla
   void SparseCholesky<double,double,double> :: FactorSPD () 
   {
     static Timer factor_timer("SparseCholesky::Factor");
-
     static Timer timerb("SparseCholesky::Factor - B");
     static Timer timerc("SparseCholesky::Factor - C");
 
@@ -703,27 +772,19 @@ namespace ngla
     int * hfirstinrow = firstinrow.Addr(0);
     int * hfirstinrow_ri = firstinrow_ri.Addr(0);
     int * hrowindex2 = rowindex2.Addr(0);
-    // double * hlfact = lfact.Addr(0);
-    
-    enum { BS = 4 };
-
-    Array<double> sum(BS*maxrow);
-
 
-    for (int i1 = 0; i1 < n;  )
+    /*
+      factor one supernode with dense kernels, and subtract its
+      contribution from the ancestor rows. Supernodes on the same level
+      of the elimination tree are independent, they may update common
+      ancestors, which is done by atomic operations.
+     */
+    auto factor_supernode = [&] (int i1, int last_same, bool parallel_merge)
       {
-	int last_same = i1;
-	while (last_same < n && blocknrs[last_same] == blocknrs[i1])
-	  last_same++;
-
-        
-        timerb.Start();
-
 	// same rows
 	int mi = last_same - i1;
-
-
         int nk = hfirstinrow[i1+1] - hfirstinrow[i1] + 1;
+
         Matrix<> a(mi, nk);
         a = 0.0;
 	for (int j = 0; j < mi; j++)
@@ -732,51 +793,6 @@ namespace ngla
             a.Row(j).Range(j+1,nk) = FlatVector<>(nk-j-1, &lfact[hfirstinrow[i1+j]]);
           }
 
-
-        /*
-          // the original version
-        for (int j = 0; j < mi; j++)
-          {
-            for (int k = 0; k < j; k++)
-              {
-                double q = -a(k,k)*a(k,j);
-                for (int l = j; l < nk; l++)
-                  a(j,l) += q * a(k,l);
-              }
-            a(j,j) = 1.0 / a(j,j);
-          }
-        */
-
-
-        /*
-          // first factor A, then calc B
-        for (int j = 0; j < mi; j++)
-          {
-            for (int k = 0; k < j; k++)
-              {
-                double q = -a(k,k)*a(k,j);
-                for (int l = j; l < mi; l++)
-                  a(j,l) += q * a(k,l);
-              }
-            a(j,j) = 1.0 / a(j,j);
-          }
-
-        *testout << "ldl = " << endl << a.Cols(0,mi);
-
-
-        for (int l = mi; l < nk; l++)
-          for (int k = 0; k < mi; k++)
-            {
-              double q = -a(k,k)*a(k,l);
-
-              for (int j = k+1; j < mi; j++)
-                a(j,l) += q*a(k,j);
-            }
-
-        *testout << "b-block = " << a.Cols(mi, nk);
-        */
-
-
         Matrix<> a1 = a.Cols(0, mi);
         Vector<> da1(mi);
 
@@ -797,17 +813,10 @@ namespace ngla
 	Matrix<> b1t = Trans(a.Cols(mi,nk));
 	int nrhs = nk-mi;
 	int ldb = mi;
-        dtrtrs_ (&uplo, &trans, &ch_diag, &na1, &nrhs, &a1(0,0), &lda, &b1t(0,0), &ldb, &info);
+        if (nrhs > 0)
+          dtrtrs_ (&uplo, &trans, &ch_diag, &na1, &nrhs, &a1(0,0), &lda, &b1t(0,0), &ldb, &info);
 	Matrix<> b1 = Trans(b1t);
 	a.Cols(mi,nk) = b1; 
-	// *testout << "b1 with lapack: " << Trans(b1t) << endl;
-	
-	/*
-        dtrtri_ (&uplo, &ch_diag, &na1, &a1(0,0), &lda, &info);
-        Matrix<> b1 = Trans(a1) * a.Cols(mi,nk) | Lapack;
-        a.Cols(mi,nk) = b1;
-	*/
-	// *testout << "b1 with invert: " << b1 << endl;
 
         for (int i = 0; i < na1; i++)
           a.Row(i) *= da1(i);
@@ -821,74 +830,25 @@ namespace ngla
             FlatVector<>(nk-j-1, &lfact[hfirstinrow[i1+j]]) = a.Row(j).Range(j+1,nk);
           }
 
-
-
-        /*
-	for (int jj = 0; jj < mi; jj++)
-	  {
-	    int firstj = hfirstinrow[i1+jj];
-	    int nk = hfirstinrow[i1+jj+1]-firstj;
-
-	    for (int i2 = 0; i2 < jj; i2++)
-	      {
-		int firsti = hfirstinrow[i1+i2] + jj-i2;
-		  
-		double q = - diag[i1+i2] * hlfact[firsti-1];
-		double qtrans = Trans (q);  
-		  
-	        for (int k = 0; k < nk; k++)
-		  hlfact[firstj+k] += qtrans * hlfact[firsti+k];
-
-		diag[i1+jj] += Trans (hlfact[firsti-1]) * q;
-	      }
-
-	    diag[i1+jj] = 1.0 / diag[i1+jj];
-	  }
-        */
-
-        timerb.Stop();
-        timerc.Start();
-
+        if (nrhs == 0) return;
 
 	// merge rows
 	int firsti_ri = hfirstinrow_ri[i1] + last_same-i1-1;
-	int firsti = hfirstinrow[i1] + last_same-i1-1;
-	int lasti = hfirstinrow[i1+1]-1;
-	mi = lasti-firsti+1;
+	mi = nrhs;
 
         Matrix<> btb = Trans(b1)*b1 | Lapack;
-        // *testout << "b^t b = " << endl << btb << endl;
 
-        // Array<double> sum(BS*maxrow);
+        // every j updates its own row, including the diagonal
+#pragma omp parallel for schedule(dynamic,16) if (parallel_merge)
 	for (int j = 0; j < mi; j++)
 	  {
-            /*
-	    for (int k = j+1; k < mi; k++)
-	      sum[k] = TSCAL_MAT(0.0);
-	    for (int i2 = i1; i2 < last_same; i2++)
-	      {
-		int first = hfirstinrow[i2] + last_same-i2-1;
-
-		double qtrans = Trans (diag[i2] * hlfact[first+j]);
-		for (int k = j+1; k < mi; k++)
-		  sum[k] += qtrans * hlfact[first+k];
-	      }
-            */
-
-            /*
-            *testout << "sum = " << endl;
-            for (int k = j+1; k < mi; k++)
-              *testout << sum[k] << " ";
-            *testout << endl;
-            */
-
-            // FlatVector<> (mi, &sum[0]) = btb.Row(j);
             auto sum = btb.Row(j);
+            int row = hrowindex2[firsti_ri+j];
+	    int firstj = hfirstinrow[row];
+	    int firstj_ri = hfirstinrow_ri[row];
 
-            
-	    // merge together
-	    int firstj = hfirstinrow[hrowindex2[firsti_ri+j]];
-	    int firstj_ri = hfirstinrow_ri[hrowindex2[firsti_ri+j]];
+#pragma omp atomic
+            diag[row] -= sum[j];
 
 	    for (int k = j+1; k < mi; k++)
 	      {
@@ -898,43 +858,37 @@ namespace ngla
 		    firstj++;
 		    firstj_ri++;
 		  }
-		    
+
+#pragma omp atomic
 		lfact[firstj] -= sum[k];
 		firstj++;
 		firstj_ri++;
 	      }
 	  }
+      };
 
-	for (int i2 = i1; i2 < last_same; i2++)
-	  {
-	    int first = hfirstinrow[i2] + last_same-i2-1;
-	    int last = hfirstinrow[i2+1];
-	    int j_ri = hfirstinrow_ri[i2] + last_same-i2-1;
 
-	    for (int j = first; j < last; j++, j_ri++)
-	      {
-		double q = diag[i2] * lfact[j];
-		diag[rowindex2[j_ri]] -= Trans (lfact[j]) * q;
-	      }
-	  }
+    for (int l = 0; l < supernode_levels.Size(); l++)
+      {
+        FlatArray<int> level = supernode_levels[l];
+        RegionTimer reglev (level.Size() > 1 ? timerb : timerc);
 
-	i1 = last_same;
-        timerc.Stop();
+        if (level.Size() == 1)
+          factor_supernode (supernodes[level[0]], supernodes[level[0]+1], true);
+        else
+#pragma omp parallel for schedule(dynamic)
+          for (int i = 0; i < level.Size(); i++)
+            factor_supernode (supernodes[level[i]], supernodes[level[i]+1], false);
       }
 
-    for (int i = 0, j = 0; i < n; i++)
+#pragma omp parallel for schedule(dynamic,100)
+    for (int i = 0; i < n; i++)
       {
 	double ai = diag[i];
-
-	int last = hfirstinrow[i+1];
-	for ( ; j < last; j++)
-	  {
-	    double hm = ai * lfact[j];
-	    lfact[j] = hm;
-	  }	
+	for (int j = hfirstinrow[i]; j < hfirstinrow[i+1]; j++)
+          lfact[j] *= ai;
       }
 
-
     if (n > 2000)
       cout << IM(4) << endl;
   }
@@ -1226,6 +1180,73 @@ namespace ngla
     const int * hfirstinrow = &firstinrow[0];
     const int * hfirstinrow_ri = &firstinrow_ri[0];
 
+    if (n > 10000 && omp_get_max_threads() > 1)
+      {
+        // supernodes on one level of the elimination tree are independent,
+        // updates of common ancestors in the forward substitution are atomic
+        timerL.Start();
+        for (int l = 0; l < supernode_levels.Size(); l++)
+          {
+            FlatArray<int> level = supernode_levels[l];
+#pragma omp parallel for schedule(dynamic) if (level.Size() > 1)
+            for (int ii = 0; ii < level.Size(); ii++)
+              {
+                int first = supernodes[level[ii]];
+                int next = supernodes[level[ii]+1];
+                int nk = hfirstinrow[first+1]-hfirstinrow[first] - (next-first-1);
+
+                VectorMem<100> tmp(nk);
+                tmp = 0.0;
+                for (int i = first; i < next; i++)
+                  {
+                    double val = hy(i);
+                    int firsti = hfirstinrow[i];
+                    int j_ri = hfirstinrow_ri[i];
+                    for (int j = 0; j < next-i-1; j++, j_ri++)
+                      hhy[hrowindex2[j_ri]] -= hlfact[firsti+j] * val;
+                    tmp += val * FlatVector<> (nk, (double*)hlfact+firsti+next-i-1);
+                  }
+
+                int j_ri = hfirstinrow_ri[first]+next-first-1;
+                for (int k = 0; k < nk; k++, j_ri++)
+#pragma omp atomic
+                  hhy[hrowindex2[j_ri]] -= tmp(k);
+              }
+          }
+        timerL.Stop();
+
+#pragma omp parallel for
+        for (int i = 0; i < n; i++)
+          hhy[i] *= hdiag[i];
+
+        timerLt.Start();
+        for (int l = supernode_levels.Size()-1; l >= 0; l--)
+          {
+            FlatArray<int> level = supernode_levels[l];
+#pragma omp parallel for schedule(dynamic) if (level.Size() > 1)
+            for (int ii = 0; ii < level.Size(); ii++)
+              {
+                int first = supernodes[level[ii]];
+                int next = supernodes[level[ii]+1];
+                for (int i = next-1; i >= first; i--)
+                  {
+                    int j_ri = hfirstinrow_ri[i];
+                    double sum = 0.0;
+                    for (int j = hfirstinrow[i]; j < hfirstinrow[i+1]; j++, j_ri++)
+                      sum += hlfact[j] * hhy[hrowindex2[j_ri]];
+                    hhy[i] -= sum;
+                  }
+              }
+          }
+        timerLt.Stop();
+
+#pragma omp parallel for
+        for (int i = 0; i < n; i++)
+          if (inner ? inner->Test(i) : (!cluster || (*cluster)[i]))
+            fy(i) += s * hy(order[i]);
+        return;
+      }
+
     timerL.Start();
 
     enum { BS = 32 };
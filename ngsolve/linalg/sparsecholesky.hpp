@@ -45,11 +45,18 @@ namespace ngla
   class SparseCholesky : public SparseFactorization
   {
     int height, nze;
+    /// ordering by nested dissection instead of minimum degree
+    bool nested_dissection;
 
     Array<int, size_t> order, firstinrow, firstinrow_ri, rowindex2, blocknrs;
     Array<TM, size_t> lfact;
     Array<TM, size_t> diag;
 
+    /// first rows of supernodes (rows of equal structure), and height
+    Array<int> supernodes;
+    /// supernodes by level in the elimination tree, leaves first
+    Table<int> supernode_levels;
+
     ///
     MinimumDegreeOrdering * mdo;
     int maxrow;
@@ -65,7 +72,8 @@ namespace ngla
     SparseCholesky (const SparseMatrix<TM,TV_ROW,TV_COL> & a, 
 		    const BitArray * ainner = NULL,
 		    const Array<int> * acluster = NULL,
-		    bool allow_refactor = 0);
+		    bool allow_refactor = 0,
+		    bool anested_dissection = false);
     ///
     ~SparseCholesky ();
     ///
@@ -76,6 +84,8 @@ namespace ngla
     void Allocate (const Array<int> & aorder, 
 		   const Array<MDOVertex> & vertices,
 		   const int * blocknr);
+    /// supernodes and their elimination tree
+    void CalcEliminationTree ();
     ///
     void Factor (); 
     void FactorSPD (); 
@@ -98,7 +108,8 @@ namespace ngla
 
     virtual void MemoryUsage (Array<MemoryUsageStruct*> & mu) const
     {
-      mu.Append (new MemoryUsageStruct ("SparseChol", nze*sizeof(TM), 1));
+      mu.Append (new MemoryUsageStruct (nested_dissection ? "SparseChol, ND" : "SparseChol, MD",
+                                        nze*sizeof(TM), 1));
     }
 
 
@@ -761,24 +761,6 @@ namespace ngla
 
   
   
-  template <typename Tarray>
-  int BinSearch(const Tarray & v, int i) {
-    int n = v.Size();
-    
-    int first = 0;
-    int last = n-1;
-    if(v[0]>i) return 0;
-    if(v[n-1] <= i) return n;
-    while(last-first>1) {
-      int m = (first+last)/2;
-      if(v[m]<i)
-            first = m;
-      else
-	last = m;
-    }
-    return first;
-  }
-  
 
   void MatrixGraph :: CalcBalancing ()
   {
@@ -851,6 +833,19 @@ namespace ngla
 
 
 
+  void BaseSparseMatrix :: FindCouplingRows (const BitArray & cols, BitArray & rows) const
+  {
+    rows.SetSize (size);
+    rows.Clear();
+    for (int i = 0; i < size; i++)
+      for (int j : GetRowIndices(i))
+        if (cols.Test(j))
+          {
+            rows.Set(i);
+            break;
+          }
+  }
+
   BaseSparseMatrix :: ~BaseSparseMatrix ()
   { 
     ;
@@ -867,6 +862,7 @@ namespace ngla
     else if (ainversetype == "superlu_dist")  SetInverseType ( SUPERLU_DIST );
     else if (ainversetype == "mumps")         SetInverseType ( MUMPS );
     else if (ainversetype == "masterinverse") SetInverseType ( MASTERINVERSE );
+    else if (ainversetype == "sparsecholesky_nd") SetInverseType ( SPARSECHOLESKY_ND );
     else SetInverseType ( SPARSECHOLESKY );
     return old_invtype;
   }
@@ -1047,6 +1043,126 @@ namespace ngla
   }
   
 
+  /*
+    Multivector kernels, for scalar matrix entries only. 
+    Block entries go vector by vector.
+  */
+  template <class TM, class SCAL>
+  inline bool HasMultiVectorKernel (const TM *, const SCAL *) { return false; }
+  inline bool HasMultiVectorKernel (const double *, const double *) { return true; }
+  inline bool HasMultiVectorKernel (const double *, const Complex *) { return true; }
+  inline bool HasMultiVectorKernel (const Complex *, const Complex *) { return true; }
+
+  /*
+    sum += sum_j a_j x.Row(index_j), a_j = data[j], or data[pos[j]]
+  */
+  template <class TM, class SCAL>
+  inline void T_AddEntriesTimesMultiVector (const TM * data, const size_t * pos, 
+                                            const int * index, size_t n,
+                                            FlatMatrix<SCAL> x, SCAL * sum)
+  {
+    int k = x.Width();
+    for (size_t j = 0; j < n; j++)
+      {
+        TM a = pos ? data[pos[j]] : data[j];
+        const SCAL * px = &x(index[j], 0);
+        for (int l = 0; l < k; l++)
+          sum[l] += a * px[l];
+      }
+  }
+
+  template <class TM, class SCAL>
+  inline void AddEntriesTimesMultiVector (const TM * data, const size_t * pos, 
+                                          const int * index, size_t n,
+                                          FlatMatrix<SCAL> x, SCAL * sum)
+  { 
+    throw Exception ("no multivector kernel for this matrix type"); 
+  }
+
+  template <class SCAL>
+  inline void AddEntriesTimesMultiVector (const double * data, const size_t * pos, 
+                                          const int * index, size_t n,
+                                          FlatMatrix<SCAL> x, SCAL * sum)
+  {
+    T_AddEntriesTimesMultiVector (data, pos, index, n, x, sum);
+  }
+
+  inline void AddEntriesTimesMultiVector (const Complex * data, const size_t * pos, 
+                                          const int * index, size_t n,
+                                          FlatMatrix<Complex> x, Complex * sum)
+  {
+    T_AddEntriesTimesMultiVector (data, pos, index, n, x, sum);
+  }
+
+
+  template <class TM, class TV_ROW, class TV_COL>
+  template <class SCAL>
+  void SparseMatrix<TM,TV_ROW,TV_COL> ::
+  MultAddMV (double s, const MultiVector<SCAL> & x, MultiVector<SCAL> & y) const
+  {
+    if (!HasMultiVectorKernel ((const TM*)NULL, (const SCAL*)NULL) ||
+        x.EntrySize() != 1 || y.EntrySize() != 1)
+      {
+        BaseMatrix::MultAdd (s, x, y);
+        return;
+      }
+
+    static Timer timer("SparseMatrix::MultAdd, multivector");
+    RegionTimer reg (timer);
+    timer.AddFlops (this->nze * x.NumVectors());
+
+    FlatMatrix<SCAL> fx = x.FM(), fy = y.FM();
+    int k = fx.Width();
+    int nt = balancing.Size()-1;
+
+    // one balanced range per iteration, also correct inside a parallel region
+#pragma omp parallel for num_threads(nt) schedule(static,1)
+    for (int tid = 0; tid < nt; tid++)
+      {
+        ArrayMem<SCAL,32> sum(k);
+        for (int i : IntRange (balancing[tid], balancing[tid+1]))
+          {
+            sum = SCAL(0.0);
+            AddEntriesTimesMultiVector (&data[0]+firsti[i], (const size_t*)NULL, &colnr[firsti[i]],
+                                        firsti[i+1]-firsti[i], fx, &sum[0]);
+            for (int l = 0; l < k; l++)
+              fy(i,l) += s * sum[l];
+          }
+      }
+  }
+
+  template <class TM, class TV_ROW, class TV_COL>
+  void SparseMatrix<TM,TV_ROW,TV_COL> ::
+  MultAdd (double s, const MultiVector<double> & x, MultiVector<double> & y) const
+  {
+    MultAddMV (s, x, y);
+  }
+
+  template <class TM, class TV_ROW, class TV_COL>
+  void SparseMatrix<TM,TV_ROW,TV_COL> ::
+  MultAdd (double s, const MultiVector<Complex> & x, MultiVector<Complex> & y) const
+  {
+    MultAddMV (s, x, y);
+  }
+  
+
+  template <class TM, class TV_ROW, class TV_COL>
+  void SparseMatrix<TM,TV_ROW,TV_COL> ::
+  MultAddRows (double s, const BaseVector & x, BaseVector & y,
+               FlatArray<int> rows) const
+  {
+    static Timer timer("SparseMatrix::MultAddRows");
+    RegionTimer reg (timer);
+
+    FlatVector<TVX> fx = x.FV<TVX>(); 
+    FlatVector<TVY> fy = y.FV<TVY>(); 
+
+#pragma omp parallel for
+    for (int i = 0; i < rows.Size(); i++)
+      fy(rows[i]) += s * RowTimesVector (rows[i], fx);
+  }
+  
+
   template <class TM, class TV_ROW, class TV_COL>
   void SparseMatrix<TM,TV_ROW,TV_COL> ::
   MultTransAdd (double s, const BaseVector & x, BaseVector & y) const
@@ -1142,7 +1258,9 @@ namespace ngla
 #endif
       }
     else
-      return make_shared<SparseCholesky<TM,TV_ROW,TV_COL>> (*this, subset);
+      return make_shared<SparseCholesky<TM,TV_ROW,TV_COL>> 
+        (*this, subset, nullptr, false, 
+         BaseSparseMatrix :: GetInverseType() == SPARSECHOLESKY_ND);
     //#endif
   }
 
@@ -1195,7 +1313,9 @@ namespace ngla
 #endif
       }
     else
-      return make_shared<SparseCholesky<TM,TV_ROW,TV_COL>> (*this, nullptr, clusters);
+      return make_shared<SparseCholesky<TM,TV_ROW,TV_COL>> 
+        (*this, nullptr, clusters, false, 
+         BaseSparseMatrix :: GetInverseType() == SPARSECHOLESKY_ND);
     // #endif
   }
 
@@ -1289,6 +1409,92 @@ namespace ngla
   }
   
   
+
+  template <class TM>
+  void SparseMatrixSymmetricTM<TM> ::
+  MemoryUsage (Array<MemoryUsageStruct*> & mu) const
+  {
+    SparseMatrixTM<TM>::MemoryUsage (mu);
+    if (firsti_trans.Size())
+      mu.Append (new MemoryUsageStruct ("SparseMatrixSym, transposed graph",
+                                        firsti_trans.Size()*sizeof(size_t) +
+                                        rownr_trans.Size()*(sizeof(int)+sizeof(size_t)), 1));
+    if (restrict_workspace)
+      mu.Append (new MemoryUsageStruct ("SparseMatrixSym, Restrict workspace (peak, released)",
+                                        restrict_workspace, 1));
+  }
+
+  template <class TM>
+  void SparseMatrixSymmetricTM<TM> ::
+  FindCouplingRows (const BitArray & cols, BitArray & rows) const
+  {
+    rows.SetSize (this->size);
+    rows.Clear();
+    for (int i = 0; i < this->size; i++)
+      for (int j : this->GetRowIndices(i))
+        {
+          if (cols.Test(j)) rows.Set(i);
+          if (cols.Test(i)) rows.Set(j);
+        }
+  }
+
+  template <class TM>
+  void SparseMatrixSymmetricTM<TM> :: CalcTransposedGraph () const
+  {
+    static Timer timer ("SparseMatrixSymmetric::CalcTransposedGraph");
+    RegionTimer reg (timer);
+
+    int n = this->size;
+    const Array<size_t> & firsti = this->firsti;
+    const Array<int, size_t> & colnr = this->colnr;
+
+    if (firsti_trans.Size() != n+1)
+      {
+        Array<int> cnt(n);
+        cnt = 0;
+        for (int i = 0; i < n; i++)
+          for (size_t j = firsti[i]; j < firsti[i+1]; j++)
+            if (colnr[j] < i) cnt[colnr[j]]++;
+
+        firsti_trans.SetSize (n+1);
+        firsti_trans[0] = 0;
+        for (int i = 0; i < n; i++)
+          firsti_trans[i+1] = firsti_trans[i] + cnt[i];
+
+        rownr_trans.SetSize (firsti_trans[n]);
+        pos_trans.SetSize (firsti_trans[n]);
+
+        // rows are visited in increasing order, so rownr_trans is sorted
+        cnt = 0;
+        for (int i = 0; i < n; i++)
+          for (size_t j = firsti[i]; j < firsti[i+1]; j++)
+            {
+              int col = colnr[j];
+              if (col < i)
+                {
+                  size_t k = firsti_trans[col] + cnt[col]++;
+                  rownr_trans[k] = i;
+                  pos_trans[k] = j;
+                }
+            }
+      }
+
+    int max_threads = omp_get_max_threads();
+    balancing_trans.SetSize (max_threads+1);
+    balancing_trans = n;
+    balancing_trans[0] = 0;
+
+    size_t total = firsti[n] + firsti_trans[n];
+    size_t sum = 0;
+    for (int i = 0, tid = 1; i < n && tid < max_threads; i++)
+      {
+        sum += (firsti[i+1]-firsti[i]) + (firsti_trans[i+1]-firsti_trans[i]);
+        while (tid < max_threads && sum * max_threads >= total * tid)
+          balancing_trans[tid++] = i+1;
+      }
+  }
+  
+
   template <class TM, class TV>
   SparseMatrixSymmetric<TM,TV> :: 
   SparseMatrixSymmetric (const MatrixGraph & agraph, bool stealgraph)
@@ -1314,13 +1520,108 @@ namespace ngla
     const FlatVector<TV_ROW> fx = x.FV<TV_ROW>();
     FlatVector<TV_COL> fy = y.FV<TV_COL>();
 
-    for (int i = 0; i < this->Height(); i++)
+    if (omp_in_parallel() || omp_get_max_threads() == 1)
+      {
+        for (int i = 0; i < this->Height(); i++)
+          {
+            fy(i) += s * RowTimesVector (i, fx);
+            AddRowTransToVectorNoDiag (i, s * fx(i), fy);
+          }
+        return;
+      }
+
+    /*
+      the scatter of the upper part would conflict between threads,
+      so we gather rows of the upper part via the transposed graph
+    */
+    if (this->balancing_trans.Size() != omp_get_max_threads()+1)
+      this->CalcTransposedGraph();
+
+#pragma omp parallel
+    {
+      int tid = omp_get_thread_num();
+      for (int i : IntRange (this->balancing_trans[tid], this->balancing_trans[tid+1]))
+        fy(i) += s * (RowTimesVector (i, fx) + ColTimesVectorNoDiag (i, fx));
+    }
+  }
+
+  template <class TM, class TV>
+  template <class SCAL>
+  void SparseMatrixSymmetric<TM,TV> :: 
+  MultAddMV (double s, const MultiVector<SCAL> & x, MultiVector<SCAL> & y) const
+  {
+    if (!HasMultiVectorKernel ((const TM*)NULL, (const SCAL*)NULL) ||
+        x.EntrySize() != 1 || y.EntrySize() != 1)
+      {
+        BaseMatrix::MultAdd (s, x, y);
+        return;
+      }
+
+    static Timer timer("SparseMatrixSymmetric::MultAdd, multivector");
+    RegionTimer reg (timer);
+    timer.AddFlops (2 * this->nze * x.NumVectors());
+
+    // also the single-threaded version gathers, so there is only one kernel
+    if (this->balancing_trans.Size() != omp_get_max_threads()+1)
+      this->CalcTransposedGraph();
+
+    FlatMatrix<SCAL> fx = x.FM(), fy = y.FM();
+    int k = fx.Width();
+    int nt = this->balancing_trans.Size()-1;
+    const TM * pdata = &data[0];
+
+#pragma omp parallel for num_threads(nt) schedule(static,1)
+    for (int tid = 0; tid < nt; tid++)
       {
-	fy(i) += s * RowTimesVector (i, fx);
-	AddRowTransToVectorNoDiag (i, s * fx(i), fy);
+        ArrayMem<SCAL,32> sum(k);
+        for (int i : IntRange (this->balancing_trans[tid], this->balancing_trans[tid+1]))
+          {
+            sum = SCAL(0.0);
+            AddEntriesTimesMultiVector (pdata+firsti[i], (const size_t*)NULL, &colnr[firsti[i]],
+                                        firsti[i+1]-firsti[i], fx, &sum[0]);
+            size_t first = this->firsti_trans[i], next = this->firsti_trans[i+1];
+            if (first < next)
+              AddEntriesTimesMultiVector (pdata, &this->pos_trans[first], &this->rownr_trans[first],
+                                          next-first, fx, &sum[0]);
+            for (int l = 0; l < k; l++)
+              fy(i,l) += s * sum[l];
+          }
       }
   }
 
+  template <class TM, class TV>
+  void SparseMatrixSymmetric<TM,TV> :: 
+  MultAdd (double s, const MultiVector<double> & x, MultiVector<double> & y) const
+  {
+    MultAddMV (s, x, y);
+  }
+
+  template <class TM, class TV>
+  void SparseMatrixSymmetric<TM,TV> :: 
+  MultAdd (double s, const MultiVector<Complex> & x, MultiVector<Complex> & y) const
+  {
+    MultAddMV (s, x, y);
+  }
+
+  template <class TM, class TV>
+  void SparseMatrixSymmetric<TM,TV> :: 
+  MultAddRows (double s, const BaseVector & x, BaseVector & y,
+               FlatArray<int> rows) const
+  {
+    static Timer timer("SparseMatrixSymmetric::MultAddRows");
+    RegionTimer reg (timer);
+
+    const FlatVector<TV_ROW> fx = x.FV<TV_ROW>();
+    FlatVector<TV_COL> fy = y.FV<TV_COL>();
+
+    if (this->firsti_trans.Size() != this->Height()+1)
+      this->CalcTransposedGraph();
+
+#pragma omp parallel for
+    for (int i = 0; i < rows.Size(); i++)
+      fy(rows[i]) += s * (RowTimesVector (rows[i], fx) + ColTimesVectorNoDiag (rows[i], fx));
+  }
+
   template <class TM, class TV>
   void SparseMatrixSymmetric<TM,TV> :: 
   MultAdd1 (double s, const BaseVector & x, BaseVector & y,
@@ -1393,9 +1694,29 @@ namespace ngla
 	  if ( (*cluster)[i])
 	    AddRowTransToVector (i, s * fx(i), fy);
       }
+    else if (omp_in_parallel() || omp_get_max_threads() == 1)
+      {
+        for (int i = 0; i < this->Height(); i++)
+          AddRowTransToVector (i, s * fx(i), fy);
+      }
     else
-      for (int i = 0; i < this->Height(); i++)
-	AddRowTransToVector (i, s * fx(i), fy);
+      {
+        if (this->balancing_trans.Size() != omp_get_max_threads()+1)
+          this->CalcTransposedGraph();
+        
+#pragma omp parallel
+        {
+          int tid = omp_get_thread_num();
+          for (int i : IntRange (this->balancing_trans[tid], this->balancing_trans[tid+1]))
+            {
+              TVY sum = ColTimesVectorNoDiag (i, fx);
+              size_t last = firsti[i+1];
+              if (last > firsti[i] && colnr[last-1] == i)
+                sum += Trans(data[last-1]) * fx(i);
+              fy(i) += s * sum;
+            }
+        }
+      }
   }
 
 
@@ -1413,6 +1734,107 @@ namespace ngla
 
 
 
+  /*
+    Sums of the contributions to one coarse row, in a closed hash table 
+    by column. The table grows with the number of different columns, so
+    the workspace is independent of the coarse size.
+  */
+  template <class TM>
+  class RestrictRowAccumulator
+  {
+    ClosedHashTable<INT<1>, TM> ht;
+    /// used positions in ht
+    Array<int> used;
+    Array<int> index, hcols;
+    Array<TM> hvals;
+
+  public:
+    RestrictRowAccumulator () : ht(64) { ; }
+
+    void Add (int col, const TM & val, bool values)
+    {
+      if (2*used.Size()+2 > ht.Size()) Grow();
+      int pos;
+      if (ht.PositionCreate (INT<1> (col), pos))
+        {
+          used.Append (pos);
+          if (values) ht.SetData (pos, val);
+        }
+      else if (values)
+        {
+          TM sum;
+          ht.GetData (pos, sum);
+          ht.SetData (pos, sum+val);
+        }
+    }
+
+    /// columns (and sums), sorted by column. Clears the accumulator
+    void Extract (Array<int> & cols, Array<TM> * vals)
+    {
+      int n = used.Size();
+      hcols.SetSize (n);
+      index.SetSize (n);
+      for (int i = 0; i < n; i++)
+        {
+          INT<1> col;
+          TM val;
+          ht.GetData (used[i], col, val);
+          hcols[i] = col[0];
+          index[i] = i;
+          ht.SetData (used[i], INT<1>(-1), val);
+        }
+      QuickSortI (hcols, index);
+
+      cols.SetSize (n);
+      for (int i = 0; i < n; i++)
+        cols[i] = hcols[index[i]];
+      if (vals)
+        {
+          vals->SetSize (n);
+          for (int i = 0; i < n; i++)
+            ht.GetData (used[index[i]], (*vals)[i]);
+        }
+      used.SetSize0();
+    }
+
+    /// bytes allocated, tables only grow, so this is also the peak
+    size_t MemoryUsage () const
+    {
+      return size_t(ht.Size()) * (sizeof(INT<1>) + sizeof(TM))
+        + (used.AllocSize() + index.AllocSize() + hcols.AllocSize()) * sizeof(int)
+        + hvals.AllocSize() * sizeof(TM);
+    }
+
+  private:
+    void Grow ()
+    {
+      hcols.SetSize (used.Size());
+      hvals.SetSize (used.Size());
+      for (int i = 0; i < used.Size(); i++)
+        {
+          INT<1> col;
+          ht.GetData (used[i], col, hvals[i]);
+          hcols[i] = col[0];
+        }
+      ht.SetSize (2*ht.Size());
+      for (int i = 0; i < hcols.Size(); i++)
+        {
+          ht.PositionCreate (INT<1> (hcols[i]), used[i]);
+          ht.SetData (used[i], hvals[i]);
+        }
+    }
+  };
+
+
+  /*
+    Galerkin product  P^T A P,  lower part only.
+
+    Row I of the coarse matrix collects  p_iI A_ij p_jJ  over the fine dofs i 
+    prolongated from I, the full rows of A (lower part and transposed graph), 
+    and the coarse dofs J <= I of p_j. Rows are independent, so the symbolic
+    and the numeric pass run over the coarse rows in parallel, each thread
+    with a RestrictRowAccumulator.
+  */
   template <class TM, class TV>
   BaseSparseMatrix * 
   SparseMatrixSymmetric<TM,TV> :: Restrict (const SparseMatrixTM<double> & prol,
@@ -1427,277 +1849,155 @@ namespace ngla
 
     SparseMatrixSymmetric<TM,TV>* cmat = 
       dynamic_cast< SparseMatrixSymmetric<TM,TV>* > ( acmat );
- 
-    // if no coarse matrix, build up matrix-graph!
-    if ( !cmat )
-      {
-        RegionTimer reg(tbuild);
-
-	Array<int> marks(n);
-	Array<INT<2> > e2v;
-	for (int i = 0; i < n; i++)
-	  for (int j = 0; j < this->GetRowIndices(i).Size(); j++)
-	    {
-	      int col = this->GetRowIndices(i)[j];
-	      FlatArray<int> prol_rowind = prol.GetRowIndices(i);
-	      FlatArray<int> prol_colind = prol.GetRowIndices(col);
-
-	      for (int k = 0; k < prol_rowind.Size(); k++)
-		for (int l = 0; l < prol_colind.Size(); l++)
-		  {
-		    int kk = prol_rowind[k];
-		    int ll = prol_colind[l];
-		    
-		    if (kk >= ll) swap (kk,ll);
-		    e2v.Append (INT<2> (kk,ll));
-		  }
-	    }
-
-	int nc = 0;
-	for (int i = 0; i < e2v.Size(); i++)
-	  nc = max2 (nc, e2v[i][1]);
-	nc++;
 
-	// *testout << "e2v = " << endl << e2v << endl;
-        
-        // count all entries in row with multiplicity
-	Array<int> cnt(nc);
-	cnt = 0;
-	for (int i = 0; i < e2v.Size(); i++)
-	  cnt[e2v[i][1]]++;
+    int nc = 0;
+    if (cmat)
+      nc = cmat->Height();
+    else
+      for (int i = 0; i < n; i++)
+        for (int kk : prol.GetRowIndices(i))
+          nc = max2 (nc, kk+1);
 
-	Table<int> v2e(cnt);
-	cnt = 0;
-	for (int i = 0; i < e2v.Size(); i++)
-	  {
-	    int v1 = e2v[i][1];
-	    v2e[v1][cnt[v1]++] = i;
-	  }
-	
-	cnt = 0;
-	marks = -1;
+    // fine dofs prolongated from the coarse dofs, and the weights
+    TableCreator<int> creator(nc);
+    for ( ; !creator.Done(); creator++)
+      for (int i = 0; i < n; i++)
+        for (int kk : prol.GetRowIndices(i))
+          if (kk < nc) creator.Add (kk, i);
+    Table<int> prolt = creator.MoveTable();
+
+    Array<int> cntt(nc);
+    for (int kk = 0; kk < nc; kk++)
+      cntt[kk] = prolt[kk].Size();
+    Table<double> prolt_val(cntt);
+
+    // peak workspace: the transposed prolongation, and the accumulators
+    // of all threads in the symbolic or in the numeric pass
+    size_t nprolt = 0;
+    for (int kk = 0; kk < nc; kk++)
+      nprolt += cntt[kk];
+    size_t workspace = nprolt * (sizeof(int)+sizeof(double)) + nc * sizeof(int);
+    size_t symbolic = 0, numeric = 0;
 
-        // count all entries in row withOUT multiplicity
-	for (int i = 0; i < nc; i++)
-	  for (int j = 0; j < v2e[i].Size(); j++)
-	    {
-	      int jj = v2e[i][j];
-	      int v0 = e2v[jj][0];
-	      if (marks[v0] != i) 
-		{
-		  cnt[i]++;
-		  marks[v0] = i;
-		}
-	    }
+#pragma omp parallel for
+    for (int kk = 0; kk < nc; kk++)
+      for (int ii = 0; ii < prolt[kk].Size(); ii++)
+        {
+          int i = prolt[kk][ii];
+          FlatArray<int> ind = prol.GetRowIndices(i);
+          FlatVector<double> val = prol.GetRowValues(i);
+          for (int k = 0; k < ind.Size(); k++)
+            if (ind[k] == kk) prolt_val[kk][ii] = val[k];
+        }
 
-	cmat = new SparseMatrixSymmetric<TM,TV> (cnt);
+    // entries A_ij, j > i, are found by the transposed graph
+    if (this->firsti_trans.Size() != n+1)
+      this->CalcTransposedGraph();
 
-	marks = -1;
-	for (int i = 0; i < nc; i++)
-	  for (int j = 0; j < v2e[i].Size(); j++)
-	    {
-	      int jj = v2e[i][j];
-	      int v0 = e2v[jj][0];
-	      if (marks[v0] != i) 
-		{
-		  marks[v0] = i;
-		  cmat -> CreatePosition (i, v0);
-		}
-	    }
-      }
+    const Array<size_t> & firsti = this->firsti;
+    const Array<int, size_t> & colnr = this->colnr;
+    const Array<size_t> & firsti_trans = this->firsti_trans;
+    const Array<int> & rownr_trans = this->rownr_trans;
+    const Array<size_t> & pos_trans = this->pos_trans;
 
-    *cmat = 0.;
-    RegionTimer reg2(tcomp);
-	  
-    for (int i = 0; i < n; i++)
+    /*
+      adds the coarse dofs J <= I of row I to acc, 
+      and the contributions  p_iI A_ij p_jJ,  if values is set
+    */
+    auto collect_row = [&] (int kk, RestrictRowAccumulator<TM> & acc, bool values)
       {
-        FlatArray<int> mat_ri = this->GetRowIndices(i);
-        FlatVector<TM> mat_rval = this->GetRowValues(i);
-
-        for (int j = 0; j < mat_ri.Size(); j++)
+        FlatArray<int> fine = prolt[kk];
+        FlatArray<double> finew = prolt_val[kk];
+        for (int ii = 0; ii < fine.Size(); ii++)
           {
-            int col = mat_ri[j];
-            TM mat_val = mat_rval[j]; 
+            int i = fine[ii];
+            double pi = finew[ii];
 
-            FlatArray<int> prol_ri_i = prol.GetRowIndices(i);
-            FlatArray<int> prol_ri_col = prol.GetRowIndices(col);
-            FlatVector<double> prol_rval_i = prol.GetRowValues(i);
-            FlatVector<double> prol_rval_col = prol.GetRowValues(col);
+            auto add_col = [&] (int j, const TM & aij)
+              {
+                FlatArray<int> ind = prol.GetRowIndices(j);
+                FlatVector<double> val = prol.GetRowValues(j);
+                for (int l = 0; l < ind.Size(); l++)
+                  {
+                    if (ind[l] > kk) continue;
+                    if (values)
+                      acc.Add (ind[l], (pi * val[l]) * aij, true);
+                    else
+                      acc.Add (ind[l], aij, false);
+                  }
+              };
 
-            for (int k = 0; k < prol_ri_i.Size(); k++)
-              for (int l = 0; l < prol_ri_col.Size(); l++)
-                {
-                  int kk = prol_ri_i[k];
-                  int ll = prol_ri_col[l];
-                  
-                  if ( kk>=ll && kk < cmat->Height() )
-                    {
-                      (*cmat)(kk,ll) += 
-                        prol_rval_i[k] * prol_rval_col[l] * mat_val; 
-                    }
-                  
-                  if (ll >= kk && i != col && ll < cmat->Height() )
-                    {
-                      (*cmat)(ll,kk) += 
-                        prol_rval_col[l] * prol_rval_i[k] * Trans(mat_val); 
-                    }
-                  
-                }
+            for (size_t j = firsti[i]; j < firsti[i+1]; j++)
+              add_col (colnr[j], this->data[j]);
+            for (size_t j = firsti_trans[i]; j < firsti_trans[i+1]; j++)
+              add_col (rownr_trans[j], Trans (this->data[pos_trans[j]]));
           }
-      }
-    return cmat;
-  }
-  
-
-
-
-
-
-
-
-
-  template <> BaseSparseMatrix * 
-  SparseMatrixSymmetric<double,double> :: Restrict (const SparseMatrixTM<double> & prol,
-                                                    BaseSparseMatrix* acmat ) const
-  {
-    static Timer t ("sparsematrix - restrict");
-    static Timer tbuild ("sparsematrix - restrict, build matrix");
-    static Timer tbuild1 ("sparsematrix - restrict, build matrix1");
-    static Timer tbuild2 ("sparsematrix - restrict, build matrix2");
-    static Timer tbuild3 ("sparsematrix - restrict, build matrix3");
-    static Timer tbuild4 ("sparsematrix - restrict, build matrix4");
-    static Timer tcomp ("sparsematrix - restrict, compute matrix");
-    RegionTimer reg(t);
-    
-    int n = this->Height();
-
-    SparseMatrixSymmetric<double,double>* cmat = 
-      dynamic_cast< SparseMatrixSymmetric<double,double>* > ( acmat );
+      };
  
     // if no coarse matrix, build up matrix-graph!
     if ( !cmat )
       {
         RegionTimer reg(tbuild);
-        tbuild1.Start();
-	Array<INT<2> > e2v;
-	for (int i = 0; i < n; i++)
-	  for (int j = 0; j < this->GetRowIndices(i).Size(); j++)
-	    {
-	      int col = this->GetRowIndices(i)[j];
-
-	      for (int kk : prol.GetRowIndices(i))
-		for (int ll : prol.GetRowIndices(col))
-		  {
-		    if (kk >= ll) swap (kk,ll);
-		    e2v.Append (INT<2> (kk,ll));
-		  }
-	    }
 
-	int nc = 0;
-        for (auto vpair : e2v)
-          nc = max2 (nc, vpair[1]);
-	nc++;
-
-        tbuild1.Stop();
-        tbuild2.Start();
-
-        // count all entries in row with multiplicity
+        // count entries per row (symbolic pass)
 	Array<int> cnt(nc);
-	cnt = 0;
-	for (int i = 0; i < e2v.Size(); i++)
-	  cnt[e2v[i][1]]++;
-
-	Table<int> v2e(cnt);
-	cnt = 0;
-	for (int i = 0; i < e2v.Size(); i++)
-	  {
-	    int v1 = e2v[i][1];
-	    v2e[v1][cnt[v1]++] = i;
-	  }
-
-        tbuild2.Stop();
-        tbuild3.Start();
-	
-	cnt = 0;
-	Array<int> marks(n);
-	marks = -1;
-
-        // count all entries in row withOUT multiplicity
-	for (int i = 0; i < nc; i++)
-	  for (int j = 0; j < v2e[i].Size(); j++)
-	    {
-	      int jj = v2e[i][j];
-	      int v0 = e2v[jj][0];
-	      if (marks[v0] != i) 
-		{
-		  cnt[i]++;
-		  marks[v0] = i;
-		}
-	    }
-
-        tbuild3.Stop();
-        tbuild4.Start();
-
-	cmat = new SparseMatrixSymmetric<double,double> (cnt);
+#pragma omp parallel
+        {
+          RestrictRowAccumulator<TM> acc;
+          Array<int> cols;
+#pragma omp for schedule(dynamic,16)
+          for (int kk = 0; kk < nc; kk++)
+            {
+              collect_row (kk, acc, false);
+              acc.Extract (cols, NULL);
+              cnt[kk] = cols.Size();
+            }
 
-	marks = -1;
-	for (int i = 0; i < nc; i++)
-	  for (int j = 0; j < v2e[i].Size(); j++)
-	    {
-	      int jj = v2e[i][j];
-	      int v0 = e2v[jj][0];
-	      if (marks[v0] != i) 
-		{
-		  marks[v0] = i;
-		  cmat -> CreatePosition (i, v0);
-		}
-	    }
+          size_t mem = acc.MemoryUsage() + cols.AllocSize() * sizeof(int);
+#pragma omp atomic
+          symbolic += mem;
+        }
+        symbolic += nc * sizeof(int);
 
-        tbuild4.Stop();
+	cmat = new SparseMatrixSymmetric<TM,TV> (cnt);
       }
 
-    *cmat = 0.;
     RegionTimer reg2(tcomp);
 
-#pragma omp parallel for	  
-    for (int i = 0; i < n; i++)
-      {
-        FlatArray<int> mat_ri = this->GetRowIndices(i);
-        FlatVector<double> mat_rval = this->GetRowValues(i);
+    // compute values, and the positions of a new graph (numeric pass)
+    bool newgraph = (cmat != acmat);
+#pragma omp parallel
+    {
+      RestrictRowAccumulator<TM> acc;
+      Array<int> ucols;
+      Array<TM> usum;
+#pragma omp for schedule(dynamic,16)
+      for (int kk = 0; kk < nc; kk++)
+        {
+          collect_row (kk, acc, true);
+          acc.Extract (ucols, &usum);
 
-        for (int j = 0; j < mat_ri.Size(); j++)
-          {
-            int col = mat_ri[j];
-            double mat_val = mat_rval[j]; 
+          if (newgraph)
+            for (int ll : ucols)
+              cmat -> CreatePosition (kk, ll);
 
-            FlatArray<int> prol_rowind = prol.GetRowIndices(i);
-            FlatArray<int> prol_colind = prol.GetRowIndices(col);
-            FlatVector<double> prol_rowval = prol.GetRowValues(i);
-            FlatVector<double> prol_colval = prol.GetRowValues(col);
+          // both sorted: merge into the row of the graph
+          FlatArray<int> rowind = cmat->GetRowIndices(kk);
+          FlatVector<TM> rowval = cmat->GetRowValues(kk);
+          for (int l = 0, u = 0; l < rowind.Size(); l++)
+            {
+              while (u < ucols.Size() && ucols[u] < rowind[l]) u++;
+              rowval(l) = (u < ucols.Size() && ucols[u] == rowind[l]) ? usum[u] : TM(0.0);
+            }
+        }
 
-            for (int k = 0; k < prol_rowind.Size(); k++)
-              for (int l = 0; l < prol_colind.Size(); l++)
-                {
-                  int kk = prol_rowind[k];
-                  int ll = prol_colind[l];
-                  
-                  if ( kk>=ll && kk < cmat->Height() )
-                    {
-#pragma omp atomic                      
-                      (*cmat)(kk,ll) += 
-                        prol_rowval[k] * prol_colval[l] * mat_val; 
-                    }
-                  
-                  if (ll >= kk && i != col && ll < cmat->Height() )
-                    {
-#pragma omp atomic                      
-                      (*cmat)(ll,kk) += 
-                        prol_colval[l] * prol_rowval[k] * Trans(mat_val); 
-                    }
-                  
-                }
-          }
-      }
+      size_t mem = acc.MemoryUsage() + ucols.AllocSize() * sizeof(int) 
+        + usum.AllocSize() * sizeof(TM);
+#pragma omp atomic
+      numeric += mem;
+    }
+
+    cmat->restrict_workspace = workspace + max2 (symbolic, numeric);
     return cmat;
   }
 
@@ -1754,7 +2054,9 @@ namespace ngla
 #endif
       }
     else
-      return make_shared<SparseCholesky<TM,TV_ROW,TV_COL>> (*this, subset);
+      return make_shared<SparseCholesky<TM,TV_ROW,TV_COL>> 
+        (*this, subset, nullptr, false, 
+         BaseSparseMatrix :: GetInverseType() == SPARSECHOLESKY_ND);
     // #endif
   }
 
@@ -1804,7 +2106,9 @@ namespace ngla
 #endif
       }
     else
-      return make_shared<SparseCholesky<TM,TV_ROW,TV_COL>> (*this, nullptr, clusters);
+      return make_shared<SparseCholesky<TM,TV_ROW,TV_COL>> 
+        (*this, nullptr, clusters, false, 
+         BaseSparseMatrix :: GetInverseType() == SPARSECHOLESKY_ND);
     // #endif
   }
 
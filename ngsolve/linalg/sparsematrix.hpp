@@ -246,7 +246,15 @@ namespace ngla
     virtual INVERSETYPE  GetInverseType () const
     { return inversetype; }
 
+    /// rows depending on x-values in cols (including the upper part for symmetric storage)
+    virtual void FindCouplingRows (const BitArray & cols, BitArray & rows) const;
 
+    /// y += s A x, only the given rows
+    virtual void MultAddRows (double s, const BaseVector & x, BaseVector & y,
+                              FlatArray<int> rows) const
+    {
+      throw Exception ("BaseSparseMatrix::MultAddRows called");
+    }
 
   };
 
@@ -495,7 +503,18 @@ namespace ngla
     virtual void MultAdd (Complex s, const BaseVector & x, BaseVector & y) const;
     virtual void MultTransAdd (Complex s, const BaseVector & x, BaseVector & y) const;
 
+    /// matrix entries are read once for all vectors
+    virtual void MultAdd (double s, const MultiVector<double> & x, MultiVector<double> & y) const;
+    virtual void MultAdd (double s, const MultiVector<Complex> & x, MultiVector<Complex> & y) const;
+
+    virtual void MultAddRows (double s, const BaseVector & x, BaseVector & y,
+                              FlatArray<int> rows) const;
+
     virtual void DoArchive (Archive & ar);
+
+  protected:
+    template <class SCAL>
+    void MultAddMV (double s, const MultiVector<SCAL> & x, MultiVector<SCAL> & y) const;
   };
 
 
@@ -505,6 +524,20 @@ namespace ngla
   {
     bool spd = false;
   protected:
+    /// transposed strict lower part (= strict upper part) by rows, for threaded MultAdd
+    mutable Array<size_t> firsti_trans;
+    /// row numbers of lower part entries in column i
+    mutable Array<int> rownr_trans;
+    /// position of these entries in data
+    mutable Array<size_t> pos_trans;
+    /// balancing for multi-threading, costs of lower and upper part
+    mutable Array<int> balancing_trans;
+    /// peak workspace of the Galerkin product which computed this matrix
+    size_t restrict_workspace = 0;
+
+    /// build transposed graph and balancing, done on first threaded MultAdd
+    void CalcTransposedGraph () const;
+
     SparseMatrixSymmetricTM (int as, int max_elsperrow)
       : SparseMatrixTM<TM> (as, max_elsperrow) { ; }
 
@@ -524,6 +557,10 @@ namespace ngla
     typedef typename mat_traits<TM>::TSCAL TSCAL;
     void SetSPD (bool aspd = true) { spd = aspd; }
     bool IsSPD () const { return spd; }
+
+    virtual void MemoryUsage (Array<MemoryUsageStruct*> & mu) const;
+    virtual void FindCouplingRows (const BitArray & cols, BitArray & rows) const;
+
     virtual void AddElementMatrix(const FlatArray<int> & dnums, const FlatMatrix<TSCAL> & elmat);
 
     virtual void AddElementMatrix(const FlatArray<int> & dnums1, 
@@ -646,6 +683,13 @@ namespace ngla
       MultAdd (s, x, y);
     }
 
+    /// lower and (transposed) upper part are gathered row by row
+    virtual void MultAdd (double s, const MultiVector<double> & x, MultiVector<double> & y) const;
+    virtual void MultAdd (double s, const MultiVector<Complex> & x, MultiVector<Complex> & y) const;
+
+    virtual void MultAddRows (double s, const BaseVector & x, BaseVector & y,
+                              FlatArray<int> rows) const;
+
 
     /*
       y += s L * x
@@ -697,6 +741,23 @@ namespace ngla
       */
     }
 
+    /*
+      column col of the lower part, without diagonal, times vector,
+      i.e. row col of the upper part. Needs the transposed graph.
+    */
+    TV_COL ColTimesVectorNoDiag (int col, const FlatVector<TVX> vec) const
+    {
+      size_t first = this->firsti_trans[col];
+      size_t last = this->firsti_trans[col+1];
+
+      typedef typename mat_traits<TVY>::TSCAL TTSCAL;
+      TVY sum = TTSCAL(0);
+
+      for (size_t j = first; j < last; j++)
+        sum += Trans(data[this->pos_trans[j]]) * vec(this->rownr_trans[j]);
+      return sum;
+    }
+
     void AddRowTransToVectorNoDiag (int row, TVY el, FlatVector<TVX> vec) const
     {
       size_t first = firsti[row];
@@ -730,6 +791,10 @@ namespace ngla
 
     virtual shared_ptr<BaseMatrix> InverseMatrix (const BitArray * subset = 0) const;
     virtual shared_ptr<BaseMatrix> InverseMatrix (const Array<int> * clusters) const;
+
+  protected:
+    template <class SCAL>
+    void MultAddMV (double s, const MultiVector<SCAL> & x, MultiVector<SCAL> & y) const;
   };
 
 
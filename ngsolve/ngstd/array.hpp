@@ -1165,6 +1165,30 @@ namespace ngstd
   }
 
 
+  /*
+    Binary search in the ascending array v (e.g. prefix sums, to balance
+    work over threads). Returns 0 if i < v[0], v.Size() if i >= v.Last(),
+    otherwise a position with v[pos] < i <= v[pos+1].
+   */
+  template <typename Tarray>
+  int BinSearch(const Tarray & v, int i) {
+    int n = v.Size();
+    
+    int first = 0;
+    int last = n-1;
+    if(v[0]>i) return 0;
+    if(v[n-1] <= i) return n;
+    while(last-first>1) {
+      int m = (first+last)/2;
+      if(v[m]<i)
+	first = m;
+      else
+	last = m;
+    }
+    return first;
+  }
+
+
 
 
 
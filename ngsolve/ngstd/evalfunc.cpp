@@ -448,6 +448,319 @@ namespace ngstd
 
 
 
+  template <typename FUNC>
+  inline void BatchBinOp (int n, double * __restrict a, const double * __restrict b, FUNC f)
+  {
+    for (int p = 0; p < n; p++)
+      a[p] = f(a[p], b[p]);
+  }
+
+  void EvalFunction :: Eval (int npts, const double * x, int xdist, 
+                             double * y, int ydist, int ydim) const
+  {
+    if (res_type.vecdim != ydim)
+      {
+	cout << "Eval called with ydim = " << ydim << ", but result.dim = " << res_type.vecdim << endl;
+	return;
+      }
+
+    // stack in SoA layout: entry k of point p is stack[k*BS+p]
+    const int BS = 32;
+    ArrayMem<double, 64*BS> mem(program.Size()*BS);
+    double * stack = &mem[0];
+
+    for (int first = 0; first < npts; first += BS)
+      {
+        int n = min2 (BS, npts-first);
+        const double * hx = x + first*xdist;
+
+        int stacksize = -1;
+        for (int i = 0; i < program.Size(); i++)
+          {
+            double * s0 = stack + stacksize*BS;   // top of stack
+            double * s1 = s0 - BS;                // second entry
+
+            switch (program[i].op)
+              {
+              case ADD:
+                BatchBinOp (n, s1, s0, [] (double a, double b) { return a+b; });
+                stacksize--;
+                break;
+                
+              case SUB:
+                BatchBinOp (n, s1, s0, [] (double a, double b) { return a-b; });
+                stacksize--;
+                break;
+                
+              case MULT:
+                BatchBinOp (n, s1, s0, [] (double a, double b) { return a*b; });
+                stacksize--;
+                break;
+                
+              case DIV:
+                BatchBinOp (n, s1, s0, [] (double a, double b) { return a/b; });
+                stacksize--;
+                break;
+
+              case VEC_ADD:
+                {
+                  int dim = program[i].vecdim;
+                  for (int j = 0; j < dim; j++)
+                    {
+                      double * a = stack + (stacksize-2*dim+j+1)*BS;
+                      double * b = stack + (stacksize-dim+j+1)*BS;
+                      for (int p = 0; p < n; p++) a[p] += b[p];
+                    }
+                  stacksize -= dim;
+                  break;
+                }
+
+              case VEC_SUB:
+                {
+                  int dim = program[i].vecdim;
+                  for (int j = 0; j < dim; j++)
+                    {
+                      double * a = stack + (stacksize-2*dim+j+1)*BS;
+                      double * b = stack + (stacksize-dim+j+1)*BS;
+                      for (int p = 0; p < n; p++) a[p] -= b[p];
+                    }
+                  stacksize -= dim;
+                  break;
+                }
+
+              case SCAL_VEC_MULT:
+                {
+                  int dim = program[i].vecdim;
+                  // scal is overwritten in the first step, so go on per point
+                  double * scal = stack + (stacksize-dim)*BS;
+                  for (int p = 0; p < n; p++)
+                    {
+                      double hs = scal[p];
+                      for (int j = 0; j < dim; j++)
+                        stack[(stacksize-dim+j)*BS+p] = hs * stack[(stacksize-dim+j+1)*BS+p];
+                    }
+                  stacksize--;
+                  break;
+                }
+
+              case VEC_VEC_MULT:
+                {
+                  int dim = program[i].vecdim;
+                  double * res = stack + (stacksize-2*dim+1)*BS;
+                  for (int p = 0; p < n; p++)
+                    {
+                      double sum = 0;
+                      for (int j = 0; j < dim; j++)
+                        sum += stack[(stacksize-2*dim+j+1)*BS+p] * stack[(stacksize-dim+j+1)*BS+p];
+                      res[p] = sum;
+                    }
+                  stacksize -= 2*dim-1;
+                  break;
+                }
+
+              case VEC_ELEM:
+                {
+                  int dim = program[i-1].vecdim;
+                  double * res = stack + (stacksize-dim)*BS;
+                  for (int p = 0; p < n; p++)
+                    {
+                      int index = int (s0[p]);
+                      res[p] = stack[(stacksize-dim+index-1)*BS+p];
+                    }
+                  stacksize -= dim;
+                  break;
+                }
+
+              case VEC_DIM:
+                {
+                  int dim = program[i-1].vecdim;
+                  stacksize -= dim-1;
+                  double * res = stack + stacksize*BS;
+                  for (int p = 0; p < n; p++) res[p] = dim;
+                  break;
+                }
+
+              case NEG:
+                for (int p = 0; p < n; p++) s0[p] = -s0[p];
+                break;
+
+              case AND:
+                for (int p = 0; p < n; p++) 
+                  s1[p] = (ToBool (s1[p]) && ToBool (s0[p])) ? 1 : 0;
+                stacksize--;
+                break;
+
+              case OR:
+                for (int p = 0; p < n; p++) 
+                  s1[p] = (ToBool (s1[p]) || ToBool (s0[p])) ? 1 : 0;
+                stacksize--;
+                break;
+
+              case NOT:
+                for (int p = 0; p < n; p++) 
+                  s0[p] = ToBool (s0[p]) ? 0 : 1;
+                break;
+
+              case GREATER:
+                for (int p = 0; p < n; p++) s1[p] = (s1[p] > s0[p]) ? 1 : 0;
+                stacksize--;
+                break;
+
+              case GREATEREQUAL:
+                for (int p = 0; p < n; p++) s1[p] = (s1[p] >= s0[p]) ? 1 : 0;
+                stacksize--;
+                break;
+
+              case EQUAL:
+                for (int p = 0; p < n; p++) s1[p] = (Abs (s1[p]-s0[p]) < eps) ? 1 : 0;
+                stacksize--;
+                break;
+
+              case LESSEQUAL:
+                for (int p = 0; p < n; p++) s1[p] = (s1[p] <= s0[p]) ? 1 : 0;
+                stacksize--;
+                break;
+
+              case LESS:
+                for (int p = 0; p < n; p++) s1[p] = (s1[p] < s0[p]) ? 1 : 0;
+                stacksize--;
+                break;
+
+              case CONSTANT:
+                {
+                  stacksize++;
+                  double val = program[i].operand.val;
+                  double * res = stack + stacksize*BS;
+                  for (int p = 0; p < n; p++) res[p] = val;
+                  break;
+                }
+
+              case VARIABLE:
+                for (int j = 0; j < program[i].vecdim; j++)
+                  {
+                    stacksize++;
+                    double * res = stack + stacksize*BS;
+                    const double * hxj = hx + program[i].operand.varnum+j;
+                    for (int p = 0; p < n; p++) res[p] = hxj[p*xdist];
+                  }
+                break;
+
+              case GLOBVAR:
+                {
+                  stacksize++;
+                  double val = *program[i].operand.globvar;
+                  double * res = stack + stacksize*BS;
+                  for (int p = 0; p < n; p++) res[p] = val;
+                  break;
+                }
+
+              case GLOBGENVAR:
+                for (int j = 0; j < program[i].operand.globgenvar->Dimension(); j++)
+                  {
+                    stacksize++;
+                    double val = program[i].operand.globgenvar->Value<double>(j);
+                    double * res = stack + stacksize*BS;
+                    for (int p = 0; p < n; p++) res[p] = val;
+                  }
+                break;
+
+              case IMAG:
+                {
+                  stacksize++;
+                  double val = Imag<double>();
+                  double * res = stack + stacksize*BS;
+                  for (int p = 0; p < n; p++) res[p] = val;
+                  break;
+                }
+
+              case FUNCTION:
+                {
+                  auto fun = program[i].operand.fun;
+                  for (int p = 0; p < n; p++) s0[p] = (*fun) (s0[p]);
+                  break;
+                }
+
+              case SIN:
+                for (int p = 0; p < n; p++) s0[p] = sin (s0[p]);
+                break;
+              case COS:
+                for (int p = 0; p < n; p++) s0[p] = cos (s0[p]);
+                break;
+              case TAN:
+                for (int p = 0; p < n; p++) s0[p] = tan (s0[p]);
+                break;
+              case ATAN:
+                for (int p = 0; p < n; p++) s0[p] = atan (s0[p]);
+                break;
+              case ATAN2:
+                for (int p = 0; p < n; p++) s1[p] = atan2 (s1[p], s0[p]);
+                stacksize--;
+                break;
+              case EXP:
+                for (int p = 0; p < n; p++) s0[p] = exp (s0[p]);
+                break;
+              case LOG:
+                for (int p = 0; p < n; p++) s0[p] = log (s0[p]);
+                break;
+              case ABS:
+                {
+                  int dim = program[i].vecdim;
+                  if (dim == 1)
+                    for (int p = 0; p < n; p++) s0[p] = Abs (s0[p]);
+                  else
+                    {
+                      double * res = stack + (stacksize-dim+1)*BS;
+                      for (int p = 0; p < n; p++)
+                        {
+                          double sum = 0.0;
+                          for (int j = 0; j < dim; j++)
+                            sum += sqr (stack[(stacksize-j)*BS+p]);
+                          res[p] = sqrt(sum);
+                        }
+                      stacksize -= dim-1;
+                    }
+                  break;
+                }
+              case SIGN:
+                for (int p = 0; p < n; p++) 
+                  s0[p] = (s0[p] > 0) ? 1 : ( (s0[p] < 0) ? -1 : 0);
+                break;
+              case SQRT:
+                for (int p = 0; p < n; p++) s0[p] = sqrt (s0[p]);
+                break;
+              case STEP:
+                for (int p = 0; p < n; p++) s0[p] = (s0[p] >= 0) ? 1 : 0;
+                break;
+
+              case COMMA:
+                break;
+
+              case BESSELJ0:
+                for (int p = 0; p < n; p++) s0[p] = bessj0 (s0[p]);
+                break;
+              case BESSELJ1:
+                for (int p = 0; p < n; p++) s0[p] = bessj1 (s0[p]);
+                break;
+              case BESSELY0:
+                for (int p = 0; p < n; p++) s0[p] = bessy0 (s0[p]);
+                break;
+              case BESSELY1:
+                for (int p = 0; p < n; p++) s0[p] = bessy1 (s0[p]);
+                break;
+
+              default:
+                cerr << "undefined operation for EvalFunction" << endl;
+              }
+          }
+
+        for (int j = 0; j < res_type.vecdim; j++)
+          for (int p = 0; p < n; p++)
+            y[(first+p)*ydist+j] = stack[j*BS+p];
+      }
+  }
+
+
+
 
   bool EvalFunction :: IsConstant () const
   {
@@ -168,6 +168,14 @@ public:
   /// evaluate multi-value complex function with real result
   void Eval (const complex<double> * x, double * y, int ydim) const;
 
+  /** evaluate multi-value function for a batch of npts points.
+      Point i reads its arguments from x+i*xdist, and writes 
+      the result to y+i*ydist.
+      Every operation is applied to the whole batch at once.
+  */
+  void Eval (int npts, const double * x, int xdist, 
+             double * y, int ydist, int ydim) const;
+
   /*
   /// evaluate multi-value function
   template <typename TIN>
@@ -510,8 +510,8 @@ namespace ngstd
     void SetSize (int asize)
     {
       size = asize;
-      hash.Alloc(size);
-      cont.Alloc(size);
+      hash.SetSize(size);
+      cont.SetSize(size);
       for (int i = 0; i < size; i++)
 	hash[i] = invalid;
     }
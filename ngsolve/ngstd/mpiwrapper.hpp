@@ -299,6 +299,26 @@ namespace ngstd
     MPI_Waitall (requests.Size(), &requests[0], MPI_STATUSES_IGNORE);
   }
   
+  /// starts a global sum of the values, in place. Complete with MyMPI_Wait
+  inline MPI_Request MyMPI_IAllReduce (FlatArray<double> values, MPI_Comm comm = ngs_comm)
+  {
+    MPI_Request request;
+#if MPI_VERSION >= 3
+    MPI_Iallreduce (MPI_IN_PLACE, &values[0], values.Size(), MPI_DOUBLE, MPI_SUM, comm, &request);
+#else
+    MPI_Allreduce (MPI_IN_PLACE, &values[0], values.Size(), MPI_DOUBLE, MPI_SUM, comm);
+    request = MPI_REQUEST_NULL;
+#endif
+    return request;
+  }
+
+  inline void MyMPI_Wait (MPI_Request & request)
+  {
+    static Timer t("dummy - wait");
+    RegionTimer r(t);
+    MPI_Wait (&request, MPI_STATUS_IGNORE);
+  }
+
   inline int MyMPI_WaitAny (const Array<MPI_Request> & requests)
   {
     static Timer t("dummy - waitany");
@@ -332,6 +352,7 @@ public:
     MPI_Init (&argc, &argv);
     ngs_comm = MPI_COMM_WORLD;
     NGSOStream::SetGlobalActive (MyMPI_GetId() == 0);
+    NgProfiler::SetTraceRank (MyMPI_GetId());
     
 #ifdef _OPENMP
     if (MyMPI_GetNTasks (MPI_COMM_WORLD) > 1)
@@ -353,6 +374,8 @@ public:
   enum { ngs_comm = 12345 };
   typedef int MPI_Comm;
   typedef int MPI_Op;
+  typedef int MPI_Request;
+  enum { MPI_REQUEST_NULL = 0 };
   inline int MyMPI_GetNTasks (MPI_Comm comm = MPI_COMM_WORLD) { return 1; }
   inline int MyMPI_GetId (MPI_Comm comm = MPI_COMM_WORLD) { return 0; }
 
@@ -370,6 +393,9 @@ public:
   template <typename T>
   inline T MyMPI_AllReduce (T d, int op = 0, MPI_Comm comm = 0)  { return d; }
 
+  inline MPI_Request MyMPI_IAllReduce (FlatArray<double> values, MPI_Comm comm = 0) { return MPI_REQUEST_NULL; }
+  inline void MyMPI_Wait (MPI_Request & request) { ; }
+
   template <typename T>
   inline T MyMPI_Reduce (T d, int op = 0, MPI_Comm comm = ngs_comm) { return d; }
 
@@ -23,6 +23,38 @@ namespace ngstd
   string NgProfiler::names[SIZE];
   int NgProfiler::usedcounter[SIZE];
   string NgProfiler::filename;
+  bool NgProfiler::trace = false;
+  NgProfiler::ThreadData NgProfiler::threaddata[MAX_THREADS];
+
+  // reference points for converting ticks to seconds
+  static TTimePoint startticks = GetTimeCounter();
+  static double startwalltime = WallTime();
+
+
+  /*
+    event tracing: every thread owns a ring buffer, 
+    so no synchronization is needed for recording
+  */
+  struct TraceEvent
+  {
+    double time;
+    int nr;
+    bool start;
+  };
+
+  class TraceBuffer
+  {
+  public:
+    TraceEvent * events = nullptr;
+    size_t cnt = 0;
+  };
+
+  enum { MAX_TRACE_THREADS = 256 };
+  static TraceBuffer tracebuffers[MAX_TRACE_THREADS];
+  static size_t tracebuffersize = 0;
+  static double tracestart = 0;
+  static int tracerank = -1;
+  static string tracefilename;
 
   NgProfiler :: NgProfiler()
   {
@@ -35,12 +67,18 @@ namespace ngstd
 
     // total_timer = CreateTimer ("total CPU time");
     // StartTimer (total_timer);
+
+    if (getenv ("NGSTRACE"))
+      StartTrace (getenv ("NGSTRACE"));
   }
 
   NgProfiler :: ~NgProfiler()
   {
     // StopTimer (total_timer);
 
+    if (trace)
+      WriteTrace();
+
     //ofstream prof;
     //prof.open("ng.prof");
 
@@ -105,23 +143,20 @@ namespace ngstd
 
   void NgProfiler :: Print (FILE * prof)
   {
-#ifdef USE_TIMEOFDAY
-    double fac = 1;
-#else
-    double fac = 1.0/CLOCKS_PER_SEC;
-#endif
-
     for (int i = 0; i < SIZE; i++)
       if (counts[i] != 0 || usedcounter[i] != 0)
 	{
+          double time = GetTime(i);
+          long int cnt = GetCounts(i);
+          double fl = GetFlops(i);
 	  // fprintf(prof,"job %3i calls %8i, time %6.2f sec",i,counts[i],double(tottimes[i]) / CLOCKS_PER_SEC);
-          fprintf(prof,"job %3i calls %8li, time %6.4f sec",i,counts[i],tottimes[i]*fac);
-	  if(flops[i])
-	    fprintf(prof,", MFlops = %6.2f",flops[i] / (double(tottimes[i])*fac) * 1e-6);
+          fprintf(prof,"job %3i calls %8li, time %6.4f sec",i,cnt,time);
+	  if(fl)
+	    fprintf(prof,", MFlops = %6.2f",fl / time * 1e-6);
 	  if(loads[i])
-	    fprintf(prof,", MLoads = %6.2f",loads[i] / (double(tottimes[i])*fac) * 1e-6);
+	    fprintf(prof,", MLoads = %6.2f",loads[i] / time * 1e-6);
 	  if(stores[i])
-	    fprintf(prof,", MStores = %6.2f",stores[i] / (double(tottimes[i])*fac) * 1e-6);
+	    fprintf(prof,", MStores = %6.2f",stores[i] / time * 1e-6);
 	  if(usedcounter[i])
 	    fprintf(prof," %s",names[i].c_str());
 	  fprintf(prof,"\n");
@@ -148,6 +183,200 @@ namespace ngstd
   }
 
 
+  NgProfiler::ThreadPage & NgProfiler :: AllocThreadPage (int tid, int nr)
+  {
+    if (tid == SHARED_THREAD)
+      {
+        // the shared page may be requested by several threads at once
+        ThreadPage * page;
+#pragma omp critical (ngprofiler_sharedpage)
+        {
+          page = threaddata[tid].pages[nr/PAGESIZE];
+          if (!page)
+            page = NewThreadPage (tid, nr);
+        }
+        return *page;
+      }
+    return *NewThreadPage (tid, nr);
+  }
+
+  NgProfiler::ThreadPage * NgProfiler :: NewThreadPage (int tid, int nr)
+  {
+    ThreadPage * page = new ThreadPage;
+    for (int i = 0; i < PAGESIZE; i++)
+      {
+        page->tottimes[i] = 0;
+        page->counts[i] = 0;
+        page->flops[i] = 0;
+      }
+    threaddata[tid].pages[nr/PAGESIZE] = page;
+    return page;
+  }
+
+  TTimePoint NgProfiler :: GetThreadTicks (int nr)
+  {
+    TTimePoint sum = 0;
+    for (auto & td : threaddata)
+      if (ThreadPage * page = td.pages[nr/PAGESIZE])
+        sum += page->tottimes[nr%PAGESIZE];
+    return sum;
+  }
+
+  long int NgProfiler :: GetThreadCounts (int nr)
+  {
+    long int sum = 0;
+    for (auto & td : threaddata)
+      if (ThreadPage * page = td.pages[nr/PAGESIZE])
+        sum += page->counts[nr%PAGESIZE];
+    return sum;
+  }
+
+  double NgProfiler :: GetThreadFlops (int nr)
+  {
+    double sum = 0;
+    for (auto & td : threaddata)
+      if (ThreadPage * page = td.pages[nr/PAGESIZE])
+        sum += page->flops[nr%PAGESIZE];
+    return sum;
+  }
+
+  double NgProfiler :: SecondsPerTick ()
+  {
+#ifdef NGS_HAVE_RDTSC
+    // calibrate tsc against the wall clock over the whole run time
+    TTimePoint ticks = GetTimeCounter() - startticks;
+    double time = WallTime() - startwalltime;
+    if (ticks <= 0 || time < 1e-3) 
+      {
+        // too short for calibration, wait 10 ms
+        double t0 = WallTime();
+        TTimePoint c0 = GetTimeCounter();
+        while (WallTime() < t0+1e-2) ;
+        return (WallTime()-t0) / (GetTimeCounter()-c0);
+      }
+    return time / ticks;
+#else
+    return double(std::chrono::steady_clock::period::num) 
+      / std::chrono::steady_clock::period::den;
+#endif
+  }
+
+  double NgProfiler :: TimerOverhead (int npairs)
+  {
+    static Timer timer("NgProfiler::TimerOverhead");
+    double maxtime = 0;
+#pragma omp parallel reduction(max:maxtime)
+    {
+      double t0 = WallTime();
+      for (int i = 0; i < npairs; i++)
+        {
+          timer.Start();
+          timer.Stop();
+        }
+      maxtime = WallTime()-t0;
+    }
+    return maxtime / npairs;
+  }
+
+
+  void NgProfiler :: StartTrace (const string & afilename, size_t buffersize)
+  {
+    tracefilename = afilename;
+    tracebuffersize = buffersize;
+    tracestart = WallTime();
+    for (auto & buf : tracebuffers)
+      buf.cnt = 0;
+    trace = true;
+  }
+
+  void NgProfiler :: SetTraceRank (int rank)
+  {
+    tracerank = rank;
+  }
+
+  void NgProfiler :: AddTraceEvent (int nr, bool start)
+  {
+#ifdef _OPENMP
+    int tid = omp_get_thread_num();
+#else
+    int tid = 0;
+#endif
+    if (tid >= MAX_TRACE_THREADS) return;
+
+    TraceBuffer & buf = tracebuffers[tid];
+    if (!buf.events)
+      buf.events = new TraceEvent[tracebuffersize];
+
+    TraceEvent & ev = buf.events[buf.cnt % tracebuffersize];
+    ev.time = WallTime() - tracestart;
+    ev.nr = nr;
+    ev.start = start;
+    buf.cnt++;
+  }
+
+  static string JSONEscape (const string & str)
+  {
+    string res;
+    for (char c : str)
+      {
+        if (c == '"' || c == '\\') res += '\\';
+        if (c >= 0 && c < 32) continue;
+        res += c;
+      }
+    return res;
+  }
+
+  void NgProfiler :: WriteTrace ()
+  {
+    trace = false;
+
+    string name = tracefilename;
+    if (tracerank >= 0)
+      name += "." + to_string (tracerank);
+    int pid = max2 (tracerank, 0);
+
+    FILE * file = fopen (name.c_str(), "w");
+    if (!file) return;
+    fprintf (file, "{\"traceEvents\":[\n");
+    fprintf (file, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"args\":{\"name\":\"rank %d\"}}",
+             pid, pid);
+
+    for (int tid = 0; tid < MAX_TRACE_THREADS; tid++)
+      {
+        TraceBuffer & buf = tracebuffers[tid];
+        if (!buf.cnt) continue;
+
+        fprintf (file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"thread %d\"}}",
+                 pid, tid, tid);
+
+        // ring buffer has overwritten the oldest events, skip unmatched stops
+        size_t first = (buf.cnt > tracebuffersize) ? buf.cnt-tracebuffersize : 0;
+        int depth = 0;
+        for (size_t i = first; i < buf.cnt; i++)
+          {
+            TraceEvent & ev = buf.events[i % tracebuffersize];
+            if (ev.start)
+              depth++;
+            else if (depth > 0)
+              depth--;
+            else
+              continue;
+
+            fprintf (file, ",\n{\"name\":\"%s\",\"ph\":\"%s\",\"ts\":%.3f,\"pid\":%d,\"tid\":%d}",
+                     JSONEscape (names[ev.nr]).c_str(), ev.start ? "B" : "E", 
+                     1e6*ev.time, pid, tid);
+          }
+        
+        delete [] buf.events;
+        buf.events = nullptr;
+        buf.cnt = 0;
+      }
+
+    fprintf (file, "\n]}\n");
+    fclose (file);
+  }
+
+
   NgProfiler prof;
 
 
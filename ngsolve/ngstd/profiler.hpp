@@ -46,6 +46,16 @@ inline double WallTime ()
 
 #endif
 
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define NGS_HAVE_RDTSC
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define NGS_HAVE_RDTSC
+#else
+#include <chrono>
+#endif
+
 #ifdef VTRACE
 #include "vt_user.h"
 #else
@@ -59,6 +69,18 @@ inline double WallTime ()
 namespace ngstd
 {
 
+  typedef long long TTimePoint;
+
+  /// cheap, monotonic tick counter. Ticks are converted to seconds at report time
+  inline TTimePoint GetTimeCounter ()
+  {
+#ifdef NGS_HAVE_RDTSC
+    return __rdtsc();
+#else
+    return std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+  }
+
 
   /**
      A built-in profile
@@ -81,11 +103,67 @@ namespace ngstd
     NGS_DLL_HEADER static string names[SIZE];
     NGS_DLL_HEADER static int usedcounter[SIZE];
 
+    /// record start/stop events of all threads
+    NGS_DLL_HEADER static bool trace;
+
+    /**
+       Every thread accumulates into its own pages of counters, 
+       so starting and stopping timers needs no synchronization. 
+       The threads' data are summed up when the profile is read.
+       Threads from SHARED_THREAD on share the last pages and
+       update them atomically.
+    */
+    enum { MAX_THREADS = 256 };
+    enum { SHARED_THREAD = MAX_THREADS-1 };
+    enum { PAGESIZE = 1024 };
+    class ThreadPage
+    {
+    public:
+      TTimePoint tottimes[PAGESIZE];
+      long int counts[PAGESIZE];
+      double flops[PAGESIZE];
+    };
+    class ThreadData
+    {
+    public:
+      ThreadPage * pages[SIZE/PAGESIZE+1];
+    };
+    NGS_DLL_HEADER static ThreadData threaddata[MAX_THREADS];
+
   private:
 
     // int total_timer;
     static string filename;
+
+    /// allocates the counter page of timer nr for the calling thread
+    NGS_DLL_HEADER static ThreadPage & AllocThreadPage (int tid, int nr);
+    static ThreadPage * NewThreadPage (int tid, int nr);
+
+    static int ThreadId ()
+    {
+#ifdef _OPENMP
+      int tid = omp_get_thread_num();
+      return (tid < SHARED_THREAD) ? tid : SHARED_THREAD;
+#else
+      return 0;
+#endif
+    }
+
+    static ThreadPage & GetThreadPage (int tid, int nr)
+    {
+      ThreadPage * page = threaddata[tid].pages[nr/PAGESIZE];
+      if (page) return *page;
+      return AllocThreadPage (tid, nr);
+    }
+
+    /// sum of thread-local tick counts
+    NGS_DLL_HEADER static TTimePoint GetThreadTicks (int nr);
+    NGS_DLL_HEADER static long int GetThreadCounts (int nr);
+    NGS_DLL_HEADER static double GetThreadFlops (int nr);
   public: 
+    /// duration of one tick of GetTimeCounter
+    NGS_DLL_HEADER static double SecondsPerTick ();
+
     /// create new profile
     NgProfiler();
     /// delete profiler
@@ -96,6 +174,21 @@ namespace ngstd
     /// create new timer, use integer index
     NGS_DLL_HEADER static int CreateTimer (const string & name);
 
+    /** 
+        Start event tracing into per-thread ring buffers, keeping the last
+        buffersize events per thread. The trace is written in Chrome
+        trace format (chrome://tracing) at exit, or by WriteTrace.
+        Also enabled by the environment variable NGSTRACE=filename.
+    */
+    NGS_DLL_HEADER static void StartTrace (const string & filename, 
+                                           size_t buffersize = 1 << 20);
+    /// write trace file and stop tracing
+    NGS_DLL_HEADER static void WriteTrace ();
+    /// MPI rank is used as process id in the trace
+    NGS_DLL_HEADER static void SetTraceRank (int rank);
+    /// add event to the buffer of the calling thread
+    NGS_DLL_HEADER static void AddTraceEvent (int nr, bool start);
+
 
 #ifndef NOPROFILE
 
@@ -103,25 +196,54 @@ namespace ngstd
 #ifdef USE_TIMEOFDAY
     static void StartTimer (int nr) 
     { 
-      timeval time;
-      gettimeofday (&time, 0);
-      // starttimes[nr] = time.tv_sec + 1e-6 * time.tv_usec;
+      int tid = ThreadId();
+      ThreadPage & page = GetThreadPage (tid, nr);
+      TTimePoint time = GetTimeCounter();
+      if (tid < SHARED_THREAD)
+        {
+          page.tottimes[nr%PAGESIZE] -= time;
+          page.counts[nr%PAGESIZE]++; 
+        }
+      else
+        {
 #pragma omp atomic
-      tottimes[nr] -= time.tv_sec + 1e-6 * time.tv_usec;
+          page.tottimes[nr%PAGESIZE] -= time;
 #pragma omp atomic
-      counts[nr]++; 
+          page.counts[nr%PAGESIZE]++; 
+        }
+      if (trace) AddTraceEvent (nr, true);
       VT_USER_START (const_cast<char*> (names[nr].c_str())); 
     }
 
     static void StopTimer (int nr) 
     { 
-      timeval time;
-      gettimeofday (&time, 0);
-      // tottimes[nr] += time.tv_sec + 1e-6 * time.tv_usec - starttimes[nr];
+      int tid = ThreadId();
+      ThreadPage & page = GetThreadPage (tid, nr);
+      TTimePoint time = GetTimeCounter();
+      if (tid < SHARED_THREAD)
+        page.tottimes[nr%PAGESIZE] += time;
+      else
+        {
 #pragma omp atomic
-      tottimes[nr] += time.tv_sec + 1e-6 * time.tv_usec;
+          page.tottimes[nr%PAGESIZE] += time;
+        }
+      if (trace) AddTraceEvent (nr, false);
       VT_USER_END (const_cast<char*> (names[nr].c_str())); 
     }
+
+    /// if you know number of flops, provide them to obtain the MFlop - rate
+    static void AddFlops (int nr, double aflops) 
+    { 
+      int tid = ThreadId();
+      ThreadPage & page = GetThreadPage (tid, nr);
+      if (tid < SHARED_THREAD)
+        page.flops[nr%PAGESIZE] += aflops;
+      else
+        {
+#pragma omp atomic
+          page.flops[nr%PAGESIZE] += aflops;
+        }
+    }
   
 #else
   
@@ -129,6 +251,7 @@ namespace ngstd
     static void StartTimer (int nr) 
     {
       starttimes[nr] = clock(); counts[nr]++; 
+      if (trace) AddTraceEvent (nr, true);
       VT_USER_START (const_cast<char*> (names[nr].c_str())); 
     }
 
@@ -136,14 +259,14 @@ namespace ngstd
     static void StopTimer (int nr) 
     { 
       tottimes[nr] += clock()-starttimes[nr]; 
+      if (trace) AddTraceEvent (nr, false);
       VT_USER_END (const_cast<char*> (names[nr].c_str())); 
     }
 
-#endif
-
-
     /// if you know number of flops, provide them to obtain the MFlop - rate
     static void AddFlops (int nr, double aflops) { flops[nr] += aflops; }
+#endif
+
     static void AddLoads (int nr, double aloads) { loads[nr] += aloads; }
     static void AddStores (int nr, double astores) { stores[nr] += astores; }
 #else
@@ -158,7 +281,7 @@ namespace ngstd
     static double GetTime (int nr)
     {
 #ifdef USE_TIMEOFDAY
-      return tottimes[nr];
+      return tottimes[nr] + GetThreadTicks(nr) * SecondsPerTick();
 #else
       return tottimes[nr]/CLOCKS_PER_SEC;
 #endif
@@ -175,14 +298,25 @@ namespace ngstd
 
     static long int GetCounts (int nr)
     {
+#ifdef USE_TIMEOFDAY
+      return counts[nr] + GetThreadCounts(nr);
+#else
       return counts[nr];
+#endif
     }
 
     static long int GetFlops (int nr)
     {
+#ifdef USE_TIMEOFDAY
+      return flops[nr] + GetThreadFlops(nr);
+#else
       return flops[nr];
+#endif
     }
 
+    /// measures the cost of one StartTimer/StopTimer pair, in seconds
+    NGS_DLL_HEADER static double TimerOverhead (int npairs = 1000000);
+
     /// change name
     static void SetName (int nr, const string & name) { names[nr] = name; }
     /// print profile
@@ -223,6 +223,11 @@ void NGS_DLL_HEADER  ExportNgstd() {
 	     return timers;
 	   }
 	   ));
+
+  bp::def("TimerOverhead", FunctionPointer
+          ([](int npairs) { return NgProfiler::TimerOverhead(npairs); }),
+          (bp::arg("npairs")=1000000),
+          "seconds per start/stop pair of a timer, measured on all threads");
   
   
   FlagsFromPythonDict();
@@ -341,6 +341,25 @@ namespace ngla
 #else
     mat->SetInverseType(MASTERINVERSE);
 #endif
+
+    auto spmat = dynamic_pointer_cast<BaseSparseMatrix> (mat);
+    if (spmat && apardofs)
+      {
+        int ndof = apardofs->GetNDofLocal();
+        BitArray exdofs(ndof);
+        exdofs.Clear();
+        for (int i = 0; i < ndof; i++)
+          if (apardofs->GetDistantProcs(i).Size())
+            exdofs.Set(i);
+
+        BitArray coupling;
+        spmat->FindCouplingRows (exdofs, coupling);
+        for (int i = 0; i < spmat->Height(); i++)
+          if (coupling.Test(i))
+            coupling_rows.Append(i);
+          else
+            inner_rows.Append(i);
+      }
   }
 
 
@@ -351,9 +370,21 @@ namespace ngla
 
   void ParallelMatrix :: MultAdd (double s, const BaseVector & x, BaseVector & y) const
   {
-    x.Cumulate();
+    const BaseSparseMatrix * spmat = dynamic_cast<const BaseSparseMatrix*> (mat.get());
+    if (!spmat || inner_rows.Size() + coupling_rows.Size() != spmat->Height())
+      {
+        x.Cumulate();
+        y.Distribute();
+        mat->MultAdd (s, x, y);
+        return;
+      }
+
+    // inner rows are computed while exchange values are on the way
+    x.StartCumulate();
     y.Distribute();
-    mat->MultAdd (s, x, y);
+    spmat->MultAddRows (s, x, y, inner_rows);
+    x.FinishCumulate();
+    spmat->MultAddRows (s, x, y, coupling_rows);
   }
 
   void ParallelMatrix :: MultTransAdd (double s, const BaseVector & x, BaseVector & y) const
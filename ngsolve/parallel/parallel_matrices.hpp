@@ -35,6 +35,11 @@ namespace ngla
   {
     shared_ptr<BaseMatrix> mat;
     // const ParallelDofs & pardofs;
+
+    /// rows not depending on exchange dofs, computed while x is cumulated
+    Array<int> inner_rows;
+    /// rows depending on exchange dofs
+    Array<int> coupling_rows;
   public:
     ParallelMatrix (shared_ptr<BaseMatrix> amat, const ParallelDofs * apardofs);
     // : mat(*amat), pardofs(*apardofs) 
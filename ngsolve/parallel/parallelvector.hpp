@@ -21,6 +21,10 @@ namespace ngla
   {
   protected:
     mutable PARALLEL_STATUS status;
+
+    /// pending communication of split-phase cumulate
+    mutable Array<int> cum_exprocs;
+    mutable Array<MPI_Request> cum_sendrequest, cum_recvrequest;
     
   public:
     ParallelBaseVector ()
@@ -68,6 +72,8 @@ namespace ngla
 
 
     virtual void Cumulate () const; 
+    virtual void StartCumulate () const; 
+    virtual void FinishCumulate () const; 
     
     virtual void Distribute() const = 0;
     // { cerr << "ERROR -- Distribute called for BaseVector, is not parallel" << endl; }
@@ -104,35 +104,56 @@ namespace ngla
   
 
   void ParallelBaseVector :: Cumulate () const
+  {
+    StartCumulate();
+    FinishCumulate();
+  }
+
+
+  void ParallelBaseVector :: StartCumulate () const
   {
     if (status != DISTRIBUTED) return;
+    if (cum_exprocs.Size()) return;   // already started
     
     int ntasks = paralleldofs->GetNTasks();
-    Array<int> exprocs;
     for (int i = 0; i < ntasks; i++)
       if (paralleldofs -> GetExchangeDofs (i).Size())
-	exprocs.Append(i);
+	cum_exprocs.Append(i);
     
-    int nexprocs = exprocs.Size();
+    int nexprocs = cum_exprocs.Size();
     
     ParallelBaseVector * constvec = const_cast<ParallelBaseVector * > (this);
     
-    Array<MPI_Request> sendrequest(nexprocs), recvrequest(nexprocs);
+    cum_sendrequest.SetSize (nexprocs);
+    cum_recvrequest.SetSize (nexprocs);
 
     for (int idest = 0; idest < nexprocs; idest ++ ) 
-      constvec->ISend (exprocs[idest], sendrequest[idest] );
+      constvec->ISend (cum_exprocs[idest], cum_sendrequest[idest] );
     for (int isender=0; isender < nexprocs; isender++)
-      constvec -> IRecvVec (exprocs[isender], recvrequest[isender] );
+      constvec -> IRecvVec (cum_exprocs[isender], cum_recvrequest[isender] );
+  }
+
+
+  void ParallelBaseVector :: FinishCumulate () const
+  {
+    if (status != DISTRIBUTED) return;
     
-    MyMPI_WaitAll (sendrequest);
+    int nexprocs = cum_exprocs.Size();
+    ParallelBaseVector * constvec = const_cast<ParallelBaseVector * > (this);
+
+    // values must not be modified before sends are completed
+    MyMPI_WaitAll (cum_sendrequest);
     
     // cumulate
     for (int cntexproc=0; cntexproc < nexprocs; cntexproc++)
       {
-	int isender = MyMPI_WaitAny (recvrequest);
-	constvec->AddRecvValues(exprocs[isender]);
+	int isender = MyMPI_WaitAny (cum_recvrequest);
+	constvec->AddRecvValues(cum_exprocs[isender]);
       } 
 
+    cum_exprocs.SetSize(0);
+    cum_sendrequest.SetSize(0);
+    cum_recvrequest.SetSize(0);
     SetStatus(CUMULATED);
   }
 
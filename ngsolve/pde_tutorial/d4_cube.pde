@@ -36,6 +36,7 @@ robin penalty
 
 # preconditioner c -type=direct -bilinearform=a
 # preconditioner c -type=local -bilinearform=a
+# preconditioner c -type=aggamg -bilinearform=a
 preconditioner c -type=multigrid -bilinearform=a -smoothingsteps=1 -smoother=block -notest -blocktype=9
 # preconditioner c -type=amg -bilinearform=a -coefe=lam -notiming -test
 
@@ -0,0 +1,68 @@
+#
+# compares operator application of assembled matrices with
+# matrix-free application by sum factorization on a hex mesh
+#
+
+from ngsolve.fem import *
+from ngsolve.comp import *
+from ngsolve.la import *
+
+
+def WriteHexMesh (filename, n):
+    def pnum(i,j,k):
+        return 1 + i + (n+1)*j + (n+1)*(n+1)*k
+
+    quads = []
+    for i in range(n):
+        for j in range(n):
+            # bottom/top, front/back, left/right, oriented outwards
+            quads.append ([pnum(i,j,0), pnum(i,j+1,0), pnum(i+1,j+1,0), pnum(i+1,j,0)])
+            quads.append ([pnum(i,j,n), pnum(i+1,j,n), pnum(i+1,j+1,n), pnum(i,j+1,n)])
+            quads.append ([pnum(i,0,j), pnum(i+1,0,j), pnum(i+1,0,j+1), pnum(i,0,j+1)])
+            quads.append ([pnum(i,n,j), pnum(i,n,j+1), pnum(i+1,n,j+1), pnum(i+1,n,j)])
+            quads.append ([pnum(0,i,j), pnum(0,i,j+1), pnum(0,i+1,j+1), pnum(0,i+1,j)])
+            quads.append ([pnum(n,i,j), pnum(n,i+1,j), pnum(n,i+1,j+1), pnum(n,i,j+1)])
+
+    f = open (filename, "w")
+    f.write ("mesh3d\ndimension\n3\ngeomtype\n0\n\n")
+
+    f.write ("surfaceelements\n%d\n" % len(quads))
+    for q in quads:
+        f.write ("1 1 1 0 4 %d %d %d %d\n" % tuple(q))
+
+    f.write ("\nvolumeelements\n%d\n" % (n*n*n))
+    for i in range(n):
+        for j in range(n):
+            for k in range(n):
+                f.write ("1 8 %d %d %d %d %d %d %d %d\n" %
+                         (pnum(i,j,k), pnum(i+1,j,k), pnum(i+1,j+1,k), pnum(i,j+1,k),
+                          pnum(i,j,k+1), pnum(i+1,j,k+1), pnum(i+1,j+1,k+1), pnum(i,j+1,k+1)))
+
+    f.write ("\npoints\n%d\n" % ((n+1)**3))
+    for k in range(n+1):
+        for j in range(n+1):
+            for i in range(n+1):
+                f.write ("%f %f %f\n" % (i/n, j/n, k/n))
+    f.write ("\nendmesh\n")
+    f.close()
+
+
+WriteHexMesh ("hexcube.vol", 8)
+mesh = Mesh ("hexcube.vol")
+
+for p in range(2,11):
+    print ("order", p)
+    v = FESpace ("l2ho", mesh, order=p)
+    v.Update()
+
+    print ("assembled matrix:")
+    a = BilinearForm (v, flags = { "timing" : True })
+    a.Add (BFI ("laplace", 3, ConstantCF(1)))
+    a.Add (BFI ("mass", 3, ConstantCF(1)))
+    a.Assemble()
+
+    print ("sum factorization:")
+    b = BilinearForm (v, flags = { "timing" : True, "nonassemble" : True })
+    b.Add (BFI ("laplace", 3, ConstantCF(1), flags = { "sumfactorization" : True }))
+    b.Add (BFI ("mass", 3, ConstantCF(1), flags = { "sumfactorization" : True }))
+    b.Assemble()
@@ -0,0 +1,9 @@
+#
+# cost of one start/stop pair of a profiler timer,
+# all threads hitting the same timer concurrently
+#
+
+from ngsolve.ngstd import *
+
+for n in [10000, 1000000]:
+    print ("pairs per thread", n, ", overhead per pair =", TimerOverhead(n)*1e9, "ns")
@@ -40,6 +40,8 @@ namespace ngsolve
     IP_TYPE ip_type;
     ///
     bool useseedvariant;
+    ///
+    bool pipelined;
   public:
     ///
     NumProcBVP (PDE & apde, const Flags & flags);
@@ -55,6 +57,7 @@ namespace ngsolve
         maxsteps(amaxsteps), prec(aprec)
     {
       print = false;
+      pipelined = false;
       solver = CG;
       ip_type = SYMMETRIC;
     }
@@ -154,6 +157,7 @@ namespace ngsolve
 
     print = flags.GetDefineFlag ("print");
     useseedvariant = flags.GetDefineFlag ("seed");
+    pipelined = flags.GetDefineFlag ("pipelined");
 
     if (solver != DIRECT)
       pde.AddVariable (string("bvp.")+flags.GetStringFlag ("name",NULL)+".its", 0.0, 6);
@@ -181,6 +185,8 @@ namespace ngsolve
       "\n-solver=<solvername> (cg|qmr|gmres|direct|bicgstab)\n"\
       "-seed\n"\
       "    use seed variant for multiple rhs\n"\
+      "-pipelined\n"\
+      "    pipelined cg, one non-blocking reduction per iteration\n"\
       "-preconditioner=<prename>\n"
       "-maxsteps=n\n"
       "-prec=eps\n"
@@ -225,8 +231,12 @@ namespace ngsolve
 	  {
           case CG:
 	    cout << IM(1) << "cg solve for real system" << endl;
-	    invmat = new CGSolver<double>(mat, *premat);
-	    break;
+            {
+              CGSolver<double> * hinv = new CGSolver<double>(mat, *premat);
+              hinv -> SetPipelined (pipelined);
+              invmat = hinv;
+              break;
+            }
           case BICGSTAB:
 	    cout << IM(1) << "bicgstab solve for real system" << endl;
 	    invmat = new BiCGStabSolver<double>(mat, *premat);
@@ -259,8 +269,12 @@ namespace ngsolve
 	  {
 	  case CG:
             cout << IM(1) << "cg solve for complex system" << endl;
-            invmat = new CGSolver<Complex>(mat, *premat);
-	    break;
+            {
+              CGSolver<Complex> * hinv = new CGSolver<Complex>(mat, *premat);
+              hinv -> SetPipelined (pipelined);
+              invmat = hinv;
+              break;
+            }
           case BICGSTAB:
 	    cout << IM(1) << "bicgstab solve for complex system" << endl;
 	    invmat = new BiCGStabSolver<Complex>(mat, *premat);
@@ -294,8 +308,12 @@ namespace ngsolve
 	  {
 	  case CG:
             cout << IM(1) << "cg solve for complex system" << endl;
-            invmat = new CGSolver<ComplexConjugate>(mat, *premat);
-	    break;
+            {
+              CGSolver<ComplexConjugate> * hinv = new CGSolver<ComplexConjugate>(mat, *premat);
+              hinv -> SetPipelined (pipelined);
+              invmat = hinv;
+              break;
+            }
           case BICGSTAB:
 	    cout << IM(1) << "bicgstab solve for complex system" << endl;
 	    invmat = new BiCGStabSolver<ComplexConjugate>(mat, *premat);
@@ -328,8 +346,12 @@ namespace ngsolve
 	  {
 	  case CG:
             cout << IM(1) << "cg solve for complex system" << endl;
-            invmat = new CGSolver<ComplexConjugate2>(mat, *premat);
-	    break;
+            {
+              CGSolver<ComplexConjugate2> * hinv = new CGSolver<ComplexConjugate2>(mat, *premat);
+              hinv -> SetPipelined (pipelined);
+              invmat = hinv;
+              break;
+            }
           case BICGSTAB:
 	    cout << IM(1) << "bicgstab solve for complex system" << endl;
 	    invmat = new BiCGStabSolver<ComplexConjugate2>(mat, *premat);
@@ -19,13 +19,14 @@ namespace ngsolve
     shared_ptr<GridFunction> gfu;
     shared_ptr<Preconditioner> pre;
     int num;
+    int maxsteps;
 
     double prec, shift, shifti;
     bool print;
 
     string filename;
 
-    enum SOLVER { DENSE, ARNOLDI };
+    enum SOLVER { DENSE, ARNOLDI, LOBPCG };
     SOLVER solver;
 
   public:
@@ -59,17 +60,76 @@ namespace ngsolve
     num = int(flags.GetNumFlag ("num", 500));
     shift = flags.GetNumFlag ("shift",1); 
     shifti = flags.GetNumFlag ("shifti",0); 
+    prec = flags.GetNumFlag ("prec", 1e-8);
+    maxsteps = int(flags.GetNumFlag ("maxsteps", 1000));
+    print = flags.GetDefineFlag ("print");
 
     filename = flags.GetStringFlag ("filename","eigen.out"); 
 
-    solver = ARNOLDI;
-    if (flags.GetDefineFlag("dense")) solver = DENSE;
+    string solvername = flags.GetStringFlag ("solver", "arnoldi");
+    if (solvername == "arnoldi")
+      solver = ARNOLDI;
+    else if (solvername == "dense")
+      solver = DENSE;
+    else if (solvername == "lobpcg")
+      solver = LOBPCG;
+    else
+      throw Exception ("evp: unknown solver '" + solvername + "', use arnoldi, dense or lobpcg");
+    if (flags.GetDefineFlag("dense"))
+      {
+        if (solver != DENSE && flags.StringFlagDefined ("solver"))
+          throw Exception ("evp: flag -dense contradicts -solver=" + solvername);
+        solver = DENSE;
+      }
   }
 
 
+  template <typename SCAL>
+  static void SolveLOBPCG (const BaseMatrix & mata, const BaseMatrix & matm,
+                           const BitArray * freedofs, const BaseMatrix * pre,
+                           double prec, int maxsteps, bool print,
+                           GridFunction & gfu, const string & filename)
+  {
+    ngla::LOBPCG<SCAL> lobpcg (mata, matm, freedofs);
+    lobpcg.SetPrecision (prec);
+    lobpcg.SetMaxSteps (maxsteps);
+    lobpcg.SetPrintRates (print);
+
+    int nev = gfu.GetMultiDim();
+    Array<double> lam;
+    Array<shared_ptr<BaseVector>> evecs;
+    lobpcg.Calc (nev, lam, evecs, pre);
+
+    ofstream eigenout(filename.c_str());
+    eigenout.precision(16);
+    for (int i = 0; i < lam.Size(); ++i)
+      eigenout << lam[i] << "\t" << sqrt(lam[i]) << endl;
+
+    for (int i = 0; i < evecs.Size(); i++)
+      gfu.GetVector(i) = *evecs[i];
+
+    cout << "lam = " << endl << lam << endl;
+  }
+
 
   void NumProcEVP :: Do(LocalHeap & lh)
   {
+    if (solver == LOBPCG)
+      {
+        cout << "solve evp with LOBPCG" << endl;
+
+        const BaseMatrix * hpre = pre ? &pre->GetMatrix() : NULL;
+        if (bfa->GetFESpace()->IsComplex())
+          SolveLOBPCG<Complex> (bfa->GetMatrix(), bfm->GetMatrix(),
+                                bfa->GetFESpace()->GetFreeDofs(), hpre,
+                                prec, maxsteps, print, *gfu, filename);
+        else
+          SolveLOBPCG<double> (bfa->GetMatrix(), bfm->GetMatrix(),
+                               bfa->GetFESpace()->GetFreeDofs(), hpre,
+                               prec, maxsteps, print, *gfu, filename);
+        return;
+      }
+
     if (solver == ARNOLDI)
       {
         cout << "new version using linalg - Arnoldi" << endl;
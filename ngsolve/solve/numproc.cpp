@@ -1912,6 +1912,9 @@ namespace ngsolve
   protected:
     string filename;
     bool ascii;
+    bool checkpoint;
+    bool compress;
+    bool nodeorder;
 
   public:
     NumProcSaveSolution (PDE & apde, const Flags & flags);
@@ -1941,12 +1944,25 @@ namespace ngsolve
   {
     filename = pde.GetDirectory()+dirslash+flags.GetStringFlag("filename","");
     ascii = flags.GetDefineFlag("ascii");
+    checkpoint = flags.GetDefineFlag("checkpoint");
+    compress = flags.GetDefineFlag("compress");
+    nodeorder = flags.GetDefineFlag("nodeorder");
   }
 
   
   void NumProcSaveSolution :: Do(LocalHeap & lh)
   {
-    if(filename != "")
+    if(filename == "") return;
+
+    if (checkpoint)
+      {
+        auto & gftab = pde.GetGridFunctionTable();
+        Array<shared_ptr<GridFunction>> gfs;
+        for (int i = 0; i < gftab.Size(); i++)
+          gfs.Append (gftab[i]);
+        SaveCheckpoint (filename, gfs, compress, nodeorder);
+      }
+    else
       pde.SaveSolution(filename,ascii);
   }
 
@@ -1961,7 +1977,13 @@ namespace ngsolve
       " -filename=<name>\n"\
       "      file where to save the solution\n"\
       " -ascii\n"\
-      "      the file is not binary\n\n";
+      "      the file is not binary\n"\
+      " -checkpoint\n"\
+      "      chunked binary checkpoint, written in parallel\n"\
+      " -compress\n"\
+      "      compress the checkpoint (needs zlib)\n"\
+      " -nodeorder\n"\
+      "      store the node-sorted dof order, for loading with a different numbering\n\n";
 
   }
 
@@ -2058,6 +2080,8 @@ namespace ngsolve
   protected:
     string filename;
     bool ascii;
+    bool checkpoint;
+    bool mapped;
 
   public:
     NumProcLoadSolution (PDE & apde, const Flags & flags);
@@ -2087,11 +2111,23 @@ namespace ngsolve
   {
     filename = pde.GetDirectory()+dirslash+flags.GetStringFlag("filename","");
     ascii = flags.GetDefineFlag("ascii");
+    checkpoint = flags.GetDefineFlag("checkpoint");
+    mapped = !flags.GetDefineFlag("nomap");
   }
 
   void NumProcLoadSolution :: Do(LocalHeap & lh)
   {
-    if(filename != "")
+    if(filename == "") return;
+
+    if (checkpoint)
+      {
+        auto & gftab = pde.GetGridFunctionTable();
+        Array<shared_ptr<GridFunction>> gfs;
+        for (int i = 0; i < gftab.Size(); i++)
+          gfs.Append (gftab[i]);
+        LoadCheckpoint (filename, gfs, mapped);
+      }
+    else
       pde.LoadSolution(filename,ascii);
   }
 
@@ -2106,7 +2142,11 @@ namespace ngsolve
       " -filename=<name>\n"\
       "      file from where to load the solution\n"\
       " -ascii\n"\
-      "      the file is not binary\n\n";
+      "      the file is not binary\n"\
+      " -checkpoint\n"\
+      "      the file is a checkpoint from savesolution -checkpoint\n"\
+      " -nomap\n"\
+      "      copy the vectors instead of using the mapped file\n\n";
 
   }
 
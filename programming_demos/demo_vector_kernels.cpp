@@ -0,0 +1,70 @@
+/*
+  Memory bandwidth of the fused Krylov vector kernels,
+  compared to the STREAM triad a = b + s c
+
+  usage:  demo_vector_kernels [size]
+ */
+
+// ng-soft header files
+#include <la.hpp>
+
+using namespace std;
+using namespace ngla;
+
+
+// runs func several times, returns the best GB/s
+template <typename TFUNC>
+double Bandwidth (size_t bytes, TFUNC func)
+{
+  double best = 1e99;
+  for (int k = 0; k < 10; k++)
+    {
+      double start = WallTime();
+      func();
+      best = min2 (best, WallTime()-start);
+    }
+  return 1e-9 * bytes / best;
+}
+
+
+int main (int argc, char ** argv)
+{
+  int n = (argc > 1) ? atoi (argv[1]) : 10000000;
+
+  VVector<double> x(n), y(n), v(n), w(n);
+  x = 1.0;
+  y = 2.0;
+  v = 1e-3;
+  w = 1e-3;
+
+  double * px = &x.FV()(0);
+  double * pv = &v.FV()(0);
+  double * pw = &w.FV()(0);
+  double triad = Bandwidth (3*sizeof(double)*n, [&] ()
+    {
+#pragma omp parallel for
+      for (int i = 0; i < n; i++)
+        px[i] = pv[i] + 0.5 * pw[i];
+    });
+
+  cout << "vector size = " << n << ", threads = " << omp_get_max_threads() << endl;
+  cout << "STREAM triad       " << triad << " GB/s" << endl;
+
+  auto report = [&] (string name, size_t bytes, function<void()> func)
+    {
+      double bw = Bandwidth (bytes*sizeof(double)*n, func);
+      cout << name << bw << " GB/s  (" << 100*bw/triad << "% of triad)" << endl;
+    };
+
+  report ("ScaleAdd           ", 3, [&] () { ScaleAdd (x, 0.5, v); });
+  report ("ScaleAdd, 2 vecs   ", 4, [&] () { ScaleAdd (x, 0.5, v, 0.5, w); });
+  report ("AddTwo             ", 6, [&] () { AddTwo (x, 1e-3, v, y, -1e-3, w); });
+  report ("AddTwoL2Norm       ", 6, [&] () { AddTwoL2Norm (x, 1e-3, v, y, -1e-3, w); });
+  report ("AddInnerProduct    ", 4, [&] () { AddInnerProduct (x, 1e-3, v, w); });
+
+  // the same operations without fusion, rated by the traffic of the fused kernels
+  report ("Add + Add          ", 6, [&] () { x.Add (1e-3, v); y.Add (-1e-3, w); });
+  report ("Add + InnerProduct ", 4, [&] () { x.Add (1e-3, v); InnerProduct (x, w); });
+
+  return 0;
+}